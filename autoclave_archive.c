@@ -0,0 +1,298 @@
+/*
+ * ============================================================
+ *  Autoklav — cykelarkiv
+ *
+ *  Layout: en post börjar alltid på en sektorgräns och får
+ *  inte gå runt partitionens slut. Kurvan skrivs före huvudet,
+ *  så en post utan giltigt huvud (avbruten skrivning) syns
+ *  aldrig. Sektorerna raderas i skrivordning, så det är alltid
+ *  de äldsta posterna som försvinner först, och en post vars
+ *  huvud finns kvar har också hela kurvan kvar.
+ * ============================================================
+ */
+
+#include "autoclave_archive.h"
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#define CYCLE_MAGIC     0x31594341u     // "ACY1"
+
+typedef struct {
+    uint32_t magic;
+    uint32_t id;
+    uint32_t start_time;
+    uint8_t  program;
+    uint8_t  result;
+    uint8_t  chamber;
+    uint8_t  reserved;
+    uint16_t period_s;
+    uint16_t samples;
+    timing_summary_t timing;
+    uint32_t data_crc;
+    uint32_t hdr_crc;               // Over everything above
+} cycle_hdr_t;
+
+#define HDR_SIZE        ((uint32_t)sizeof(cycle_hdr_t))
+#define HDR_CRC_LEN     (offsetof(cycle_hdr_t, hdr_crc))
+
+struct archive_rec {
+    uint32_t start_time;
+    uint16_t period_s;
+    uint16_t samples;
+    uint8_t  program;
+    uint8_t  chamber;
+    archive_sample_t data[ARCHIVE_MAX_SAMPLES];
+};
+
+static const flash_part_t *g_part;
+static uint32_t        g_ss;            // Sector size
+static uint32_t        g_nsect;
+static uint32_t        g_head;          // Next sector to write
+static uint32_t        g_next_id = 1;
+static archive_entry_t g_idx[ARCHIVE_MAX_CYCLES];
+static int             g_count;
+
+static uint32_t span_sectors(uint32_t samples)
+{
+    return (HDR_SIZE + samples * (uint32_t)sizeof(archive_sample_t) + g_ss - 1) / g_ss;
+}
+
+static int cmp_id(const void *a, const void *b)
+{
+    uint32_t x = ((const archive_entry_t *)a)->id, y = ((const archive_entry_t *)b)->id;
+    return x < y ? -1 : x > y;
+}
+
+// ═══════════════════════════════════════════════════════════════
+//  INDEX
+// ═══════════════════════════════════════════════════════════════
+bool archive_init(const flash_part_t *part)
+{
+    g_part = part;
+    g_count = 0;
+    g_head = 0;
+    g_next_id = 1;
+    if (!part || part->sector_size < HDR_SIZE) return false;
+
+    g_ss = part->sector_size;
+    g_nsect = part->size / g_ss;
+    if (g_nsect > ARCHIVE_MAX_CYCLES) g_nsect = ARCHIVE_MAX_CYCLES;
+
+    for (uint32_t s = 0; s < g_nsect; s++) {
+        cycle_hdr_t h;
+        if (!part->read(part, s * g_ss, &h, sizeof(h))) continue;
+        if (h.magic != CYCLE_MAGIC || h.hdr_crc != flash_crc32(0, &h, HDR_CRC_LEN)) continue;
+        if (h.samples > ARCHIVE_MAX_SAMPLES || s + span_sectors(h.samples) > g_nsect) continue;
+        g_idx[g_count++] = (archive_entry_t){
+            .id = h.id, .start_time = h.start_time, .sector = (uint16_t)s,
+            .samples = h.samples, .period_s = h.period_s,
+            .program = h.program, .result = h.result, .chamber = h.chamber,
+        };
+    }
+    qsort(g_idx, (size_t)g_count, sizeof(g_idx[0]), cmp_id);
+
+    if (g_count) {
+        const archive_entry_t *n = &g_idx[g_count - 1];
+        g_head = (n->sector + span_sectors(n->samples)) % g_nsect;
+        g_next_id = n->id + 1;
+    }
+    return true;
+}
+
+int archive_count(void)
+{
+    return g_count;
+}
+
+const archive_entry_t *archive_at(int i)
+{
+    return i >= 0 && i < g_count ? &g_idx[i] : NULL;
+}
+
+const archive_entry_t *archive_find_id(uint32_t id)
+{
+    int lo = 0, hi = g_count;
+    while (lo < hi) {
+        int mid = (lo + hi) / 2;
+        if (g_idx[mid].id < id) lo = mid + 1;
+        else                    hi = mid;
+    }
+    return lo < g_count && g_idx[lo].id == id ? &g_idx[lo] : NULL;
+}
+
+// The index is in ID order; a clock set back (or not yet set at
+// boot) makes start times non-monotonic, so scan from the newest
+int archive_find_time(uint32_t t)
+{
+    int i = g_count;
+    while (i > 0 && g_idx[i - 1].start_time >= t) i--;
+    return i;
+}
+
+static bool read_header(const archive_entry_t *e, cycle_hdr_t *h)
+{
+    return g_part && g_part->read(g_part, e->sector * g_ss, h, sizeof(*h)) &&
+           h->magic == CYCLE_MAGIC && h->id == e->id;
+}
+
+bool archive_get_timing(const archive_entry_t *e, timing_summary_t *out)
+{
+    cycle_hdr_t h;
+    if (!read_header(e, &h)) return false;
+    *out = h.timing;
+    return true;
+}
+
+bool archive_verify(const archive_entry_t *e)
+{
+    cycle_hdr_t h;
+    if (!read_header(e, &h)) return false;
+    archive_sample_t buf[ARCHIVE_CHUNK];
+    uint32_t crc = 0, off = e->sector * g_ss + HDR_SIZE;
+    for (uint32_t i = 0; i < h.samples; i += ARCHIVE_CHUNK) {
+        uint32_t n = h.samples - i < ARCHIVE_CHUNK ? h.samples - i : ARCHIVE_CHUNK;
+        if (!g_part->read(g_part, off + i * sizeof(buf[0]), buf, n * sizeof(buf[0])))
+            return false;
+        crc = flash_crc32(crc, buf, n * sizeof(buf[0]));
+    }
+    return crc == h.data_crc;
+}
+
+// Drops index entries whose record starts in [first, first + n)
+static void evict(uint32_t first, uint32_t n)
+{
+    int w = 0;
+    for (int r = 0; r < g_count; r++) {
+        if (g_idx[r].sector >= first && g_idx[r].sector < first + n) continue;
+        g_idx[w++] = g_idx[r];
+    }
+    g_count = w;
+}
+
+// ═══════════════════════════════════════════════════════════════
+//  RECORDING
+// ═══════════════════════════════════════════════════════════════
+archive_rec_t *archive_begin(uint8_t program, uint8_t chamber, uint16_t period_s)
+{
+    if (!g_part || period_s == 0) return NULL;
+    archive_rec_t *r = malloc(sizeof(*r));
+    if (!r) return NULL;
+    r->start_time = (uint32_t)time(NULL);
+    r->period_s   = period_s;
+    r->samples    = 0;
+    r->program    = program;
+    r->chamber    = chamber;
+    return r;
+}
+
+bool archive_add(archive_rec_t *r, float temp_c, float bar)
+{
+    if (!r || r->samples >= ARCHIVE_MAX_SAMPLES) return false;
+    r->data[r->samples++] = (archive_sample_t){
+        (int16_t)(temp_c * 10.0f + (temp_c < 0 ? -0.5f : 0.5f)),
+        (int16_t)(bar * 100.0f + (bar < 0 ? -0.5f : 0.5f)),
+    };
+    return true;
+}
+
+uint32_t archive_end(archive_rec_t *r, archive_result_t result,
+                     const timing_summary_t *timing)
+{
+    if (!r) return 0;
+    uint32_t k = span_sectors(r->samples);
+    if (k > g_nsect) {
+        free(r);
+        return 0;
+    }
+    uint32_t s = g_head + k > g_nsect ? 0 : g_head;
+
+    evict(s, k);
+    uint32_t bytes = r->samples * (uint32_t)sizeof(archive_sample_t);
+    cycle_hdr_t h = {
+        .magic = CYCLE_MAGIC, .id = g_next_id, .start_time = r->start_time,
+        .program = r->program, .result = (uint8_t)result, .chamber = r->chamber,
+        .period_s = r->period_s, .samples = r->samples,
+        .data_crc = flash_crc32(0, r->data, bytes),
+    };
+    if (timing) h.timing = *timing;
+    h.hdr_crc = flash_crc32(0, &h, HDR_CRC_LEN);
+
+    // Curve first, header last: a torn record has no header
+    bool ok = g_part->erase(g_part, s * g_ss, k * g_ss) &&
+              (bytes == 0 || g_part->write(g_part, s * g_ss + HDR_SIZE, r->data, bytes)) &&
+              g_part->write(g_part, s * g_ss, &h, sizeof(h));
+    g_head = (s + k) % g_nsect;
+    free(r);
+    if (!ok) return 0;
+
+    if (g_count == ARCHIVE_MAX_CYCLES) evict(g_idx[0].sector, 1);
+    g_idx[g_count++] = (archive_entry_t){
+        .id = h.id, .start_time = h.start_time, .sector = (uint16_t)s,
+        .samples = h.samples, .period_s = h.period_s,
+        .program = h.program, .result = h.result, .chamber = h.chamber,
+    };
+    return g_next_id++;
+}
+
+void archive_discard(archive_rec_t *r)
+{
+    free(r);
+}
+
+// ═══════════════════════════════════════════════════════════════
+//  READING
+// ═══════════════════════════════════════════════════════════════
+void archive_cursor_open(archive_cursor_t *c, const archive_entry_t *e)
+{
+    c->e = *e;
+    c->first = 0;
+    c->n = 0;
+}
+
+// Loads up to 'want' samples starting at idx into the cursor
+static bool cursor_load(archive_cursor_t *c, uint32_t idx, uint32_t want)
+{
+    // The record may have been overwritten since the cursor was opened
+    if (!archive_find_id(c->e.id)) return false;
+    uint32_t n = c->e.samples - idx < want ? c->e.samples - idx : want;
+    uint32_t off = c->e.sector * g_ss + HDR_SIZE + idx * (uint32_t)sizeof(archive_sample_t);
+    if (!g_part->read(g_part, off, c->buf, n * sizeof(archive_sample_t))) {
+        c->n = 0;
+        return false;
+    }
+    c->first = idx;
+    c->n = n;
+    return true;
+}
+
+static bool cursor_get(archive_cursor_t *c, uint32_t idx, uint32_t want, archive_sample_t *out)
+{
+    if (idx >= c->e.samples) return false;
+    if ((idx < c->first || idx >= c->first + c->n) && !cursor_load(c, idx, want))
+        return false;
+    *out = c->buf[idx - c->first];
+    return true;
+}
+
+bool archive_cursor_get(archive_cursor_t *c, uint32_t idx, archive_sample_t *out)
+{
+    return cursor_get(c, idx, ARCHIVE_CHUNK, out);
+}
+
+bool archive_cursor_at_time(archive_cursor_t *c, uint32_t elapsed_s, archive_sample_t *out)
+{
+    return archive_cursor_get(c, elapsed_s / c->e.period_s, out);
+}
+
+size_t archive_cursor_read(archive_cursor_t *c, uint32_t first, uint32_t count,
+                           uint32_t stride, archive_sample_t *out)
+{
+    if (stride == 0) stride = 1;
+    // Sparse reads fetch single samples, dense ones whole chunks
+    uint32_t want = stride < ARCHIVE_CHUNK / 4 ? ARCHIVE_CHUNK : 1;
+    size_t got = 0;
+    for (uint32_t k = 0; k < count; k++, got++)
+        if (!cursor_get(c, first + k * stride, want, &out[k])) break;
+    return got;
+}
@@ -0,0 +1,79 @@
+#pragma once
+
+#include "autoclave_flash.h"
+#include "autoclave_timing.h"
+
+/* ============================================================
+ * Autoclave Control System - cycle archive
+ * One record per finished cycle on its own flash partition:
+ * a CRC-protected header (ID, program, start time, result,
+ * loop timing) followed by the sampled temperature/pressure
+ * curve. Records start on a sector boundary and the oldest are
+ * overwritten first.
+ *
+ * Boot reads one header per sector into a RAM index sorted by
+ * cycle ID (= batch number); ID lookup is a binary search. The
+ * wall clock can be set back, so the time lookup scans the
+ * index. Curves are read through a cursor that streams only the
+ * requested samples in small chunks.
+ * ============================================================ */
+
+#define ARCHIVE_MAX_CYCLES   1024
+#define ARCHIVE_MAX_SAMPLES  4096        // Per cycle
+#define ARCHIVE_CHUNK        64          // Samples per cursor read
+
+typedef enum {
+    ARCHIVE_RESULT_OK,
+    ARCHIVE_RESULT_ABORTED,
+    ARCHIVE_RESULT_FAILED,
+} archive_result_t;
+
+typedef struct {
+    int16_t temp_d;         // 0.1 °C
+    int16_t pres_c;         // 0.01 bar
+} archive_sample_t;
+
+// RAM index entry
+typedef struct {
+    uint32_t id;
+    uint32_t start_time;    // Unix seconds
+    uint16_t sector;        // First sector of the record
+    uint16_t samples;
+    uint16_t period_s;
+    uint8_t  program;
+    uint8_t  result;
+    uint8_t  chamber;
+} archive_entry_t;
+
+bool  archive_init(const flash_part_t *part);
+
+int   archive_count(void);
+const archive_entry_t *archive_at(int i);              // 0 = oldest
+const archive_entry_t *archive_find_id(uint32_t id);
+int   archive_find_time(uint32_t t);                   // After the newest entry started before t
+bool  archive_get_timing(const archive_entry_t *e, timing_summary_t *out);
+bool  archive_verify(const archive_entry_t *e);        // Reads and checks the whole curve
+
+// ─── Recording ───────────────────────────────────────────────
+typedef struct archive_rec archive_rec_t;
+
+archive_rec_t *archive_begin(uint8_t program, uint8_t chamber, uint16_t period_s);
+bool     archive_add(archive_rec_t *r, float temp_c, float bar);   // false when full
+uint32_t archive_end(archive_rec_t *r, archive_result_t result,
+                     const timing_summary_t *timing);             // Cycle ID, 0 on error
+void     archive_discard(archive_rec_t *r);
+
+// ─── Reading ─────────────────────────────────────────────────
+typedef struct {
+    archive_entry_t  e;
+    uint32_t         first;         // Index of buf[0]
+    uint32_t         n;             // Valid samples in buf
+    archive_sample_t buf[ARCHIVE_CHUNK];
+} archive_cursor_t;
+
+void   archive_cursor_open(archive_cursor_t *c, const archive_entry_t *e);
+bool   archive_cursor_get(archive_cursor_t *c, uint32_t idx, archive_sample_t *out);
+bool   archive_cursor_at_time(archive_cursor_t *c, uint32_t elapsed_s, archive_sample_t *out);
+// count samples from 'first', every 'stride'; returns samples read
+size_t archive_cursor_read(archive_cursor_t *c, uint32_t first, uint32_t count,
+                           uint32_t stride, archive_sample_t *out);
@@ -0,0 +1,206 @@
+/*
+ * ============================================================
+ *  Autoklav — temperaturreglering
+ *
+ *  Modellbaserad uppvärmning:
+ *    1. Full effekt. När temperaturen börjat stiga anpassas
+ *       dT/dt = a − b·(T − T0) med minsta kvadrat, vilket ger
+ *       tau = 1/b, K = a/b och dödtiden ur stigtidpunkten.
+ *    2. Full effekt tills kammarens tillstånd en dödtid framåt
+ *       (det som ännu inte syns i mätningen) når börvärdet.
+ *    3. Hålleffekt (T_bör − T0)/K medan dödtiden klingar av.
+ *    4. PID med integratorn förladdad till hålleffekten.
+ * ============================================================
+ */
+
+#include "autoclave_ctrl.h"
+#include <math.h>
+#include <string.h>
+
+#define IDENT_RISE_C        1.0f    // Rise that marks the end of the dead time
+#define IDENT_FRACTION      0.5f    // Identify over this share of the climb
+#define IDENT_MAX_S         300.0f
+#define IDENT_MIN_SAMPLES   20
+#define TAU_MAX_S           20000.0f
+#define NEAR_SETPOINT_C     5.0f    // Closer than this at start: straight to PID
+#define COAST_DONE_C        1.0f
+
+static float clampf(float v, float lo, float hi)
+{
+    return v < lo ? lo : (v > hi ? hi : v);
+}
+
+// Temperature the chamber reaches after 'dur_s' at duty 'u', from x0
+static float model_predict(const fopdt_model_t *m, float x0, float u, float dur_s)
+{
+    float x_inf = m->ambient_c + m->K * u;
+    return x_inf + (x0 - x_inf) * expf(-dur_s / m->tau_s);
+}
+
+static float hold_duty(const ctrl_t *c)
+{
+    return clampf((c->setpoint_c - c->model.ambient_c) / c->model.K, 0.0f, 1.0f);
+}
+
+static float pid_step(ctrl_t *c, float temp_c)
+{
+    float err = c->setpoint_c - temp_c;
+    float p = c->kp / 100.0f * err;
+    float d = -c->kd / 100.0f * (temp_c - c->prev_temp) / c->dt_s;
+    float i = c->integ + c->ki / 100.0f / 60.0f * err * c->dt_s;
+
+    // Conditional integration: don't wind further into saturation
+    float u = p + i + d;
+    if ((u > 1.0f && err > 0) || (u < 0.0f && err < 0))
+        u = p + c->integ + d;
+    else
+        c->integ = clampf(i, 0.0f, 1.0f);
+    return clampf(u, 0.0f, 1.0f);
+}
+
+static void enter_hold(ctrl_t *c, float temp_c, float integ)
+{
+    c->phase = CTRL_HOLD;
+    c->integ = integ;
+    c->prev_temp = temp_c;
+}
+
+// Least-squares fit of dT/dt = a − b·(T − T0)
+static bool ident_finish(ctrl_t *c)
+{
+    if (c->n < IDENT_MIN_SAMPLES) return false;
+    double n = c->n;
+    double den = n * c->sxx - c->sx * c->sx;
+    if (den <= 0) return false;
+    double slope = (n * c->sxy - c->sx * c->sy) / den;
+    double a = (c->sy - slope * c->sx) / n;
+    if (a <= 0) return false;
+
+    double b = -slope;
+    if (b < 1.0 / TAU_MAX_S) b = 1.0 / TAU_MAX_S;   // Still straight: near-integrating
+    fopdt_model_t *m = &c->model;
+    m->tau_s  = (float)(1.0 / b);
+    m->K      = (float)(a / b);
+    m->dead_s = fmaxf(0.0f, c->rise_s - IDENT_RISE_C / (float)a);
+    m->valid  = true;
+    return true;
+}
+
+static void ident_sample(ctrl_t *c, float temp_c)
+{
+    float rise = temp_c - c->model.ambient_c;
+    if (c->rise_s < 0 && rise > IDENT_RISE_C) c->rise_s = c->elapsed_s;
+
+    float oldest = c->hist[c->nhist % CTRL_IDENT_LAG];
+    c->hist[c->nhist % CTRL_IDENT_LAG] = temp_c;
+    c->nhist++;
+
+    // Only fit slopes that lie entirely after the dead time
+    float span_s = CTRL_IDENT_LAG * c->dt_s;
+    if (c->rise_s >= 0 && c->nhist > CTRL_IDENT_LAG &&
+        c->elapsed_s - span_s >= c->rise_s) {
+        double x = 0.5 * (temp_c + oldest) - c->model.ambient_c;
+        double y = (temp_c - oldest) / span_s;
+        c->sx += x; c->sy += y; c->sxx += x * x; c->sxy += x * y;
+        c->n++;
+    }
+}
+
+// ═══════════════════════════════════════════════════════════════
+//  PUBLIC API
+// ═══════════════════════════════════════════════════════════════
+void ctrl_init(ctrl_t *c, float dt_s, bool model_based)
+{
+    memset(c, 0, sizeof(*c));
+    c->dt_s = dt_s;
+    c->model_based = model_based;
+    c->kp = 2.5f; c->ki = 0.8f; c->kd = 0.3f;
+}
+
+void ctrl_set_gains(ctrl_t *c, float kp, float ki, float kd)
+{
+    c->kp = kp; c->ki = ki; c->kd = kd;
+}
+
+void ctrl_start(ctrl_t *c, float setpoint_c, float temp_c)
+{
+    c->setpoint_c = setpoint_c;
+    c->elapsed_s  = 0;
+    c->out        = 0;
+    c->switch_s   = -1;
+    c->nhist = 0; c->n = 0;
+    c->sx = c->sy = c->sxx = c->sxy = 0;
+    c->rise_s = -1;
+    memset(&c->model, 0, sizeof(c->model));
+    c->model.ambient_c = temp_c;
+
+    if (c->model_based && setpoint_c - temp_c > NEAR_SETPOINT_C)
+        c->phase = CTRL_IDENTIFY;
+    else
+        enter_hold(c, temp_c, 0);
+}
+
+void ctrl_stop(ctrl_t *c)
+{
+    c->phase = CTRL_IDLE;
+    c->out = 0;
+}
+
+float ctrl_step(ctrl_t *c, float temp_c)
+{
+    switch (c->phase) {
+    case CTRL_IDLE:
+        c->out = 0;
+        break;
+
+    case CTRL_IDENTIFY:
+        c->out = 1.0f;
+        ident_sample(c, temp_c);
+        {
+            float climb = c->setpoint_c - c->model.ambient_c;
+            bool enough = temp_c - c->model.ambient_c >= IDENT_FRACTION * climb ||
+                          c->elapsed_s >= IDENT_MAX_S;
+            if (enough || temp_c >= c->setpoint_c - NEAR_SETPOINT_C) {
+                if (ident_finish(c)) c->phase = CTRL_HEAT;
+                else enter_hold(c, temp_c, 0);    // No usable model: plain PID
+            }
+        }
+        if (c->phase != CTRL_HEAT) break;
+        /* fall through */
+
+    case CTRL_HEAT:
+        // Chamber state one dead time ahead of the measurement
+        if (model_predict(&c->model, temp_c, 1.0f, c->model.dead_s) >= c->setpoint_c) {
+            c->phase = CTRL_COAST;
+            c->switch_s = c->elapsed_s;
+            c->out = hold_duty(c);
+        } else {
+            c->out = 1.0f;
+        }
+        break;
+
+    case CTRL_COAST:
+        c->out = hold_duty(c);
+        if (temp_c >= c->setpoint_c - COAST_DONE_C ||
+            c->elapsed_s - c->switch_s > 2.0f * c->model.dead_s + 30.0f)
+            enter_hold(c, temp_c, c->out);
+        break;
+
+    case CTRL_HOLD:
+        c->out = pid_step(c, temp_c);
+        break;
+    }
+
+    c->prev_temp = temp_c;
+    c->elapsed_s += c->dt_s;
+    return c->out;
+}
+
+float ctrl_model_heat_time(const fopdt_model_t *m, float from_c, float to_c)
+{
+    if (!m->valid) return -1.0f;
+    if (to_c <= from_c) return 0.0f;
+    float x_inf = m->ambient_c + m->K;
+    if (to_c >= x_inf) return -1.0f;
+    return m->dead_s + m->tau_s * logf((x_inf - from_c) / (x_inf - to_c));
+}
@@ -0,0 +1,72 @@
+#pragma once
+
+#include <stdbool.h>
+#include <stdint.h>
+
+/* ============================================================
+ * Autoclave Control System - chamber temperature controller
+ *
+ * Plain mode: PID from the start of the run.
+ * Model-based mode: full SSR power while a first-order-plus-
+ * dead-time (FOPDT) model is identified from the heat-up, then
+ * the output switches to the predicted holding duty at the point
+ * where the delayed temperature will land on the setpoint. PID
+ * takes over for the hold, bumplessly.
+ *
+ * Gain units (same as the PID sliders):
+ *   Kp  %/°C     Ki  %/(°C·min)     Kd  %·s/°C
+ * ctrl_step() is the control step; wrap it with timing_begin()/
+ * timing_end(TIMING_CONTROL) in the control task.
+ * ============================================================ */
+
+typedef enum {
+    CTRL_IDLE,
+    CTRL_IDENTIFY,      // Full power, collecting the model
+    CTRL_HEAT,          // Full power, waiting for the switch-over point
+    CTRL_COAST,         // Holding duty, dead time draining
+    CTRL_HOLD,          // PID
+} ctrl_phase_t;
+
+typedef struct {
+    float K;            // °C rise at 100 % duty, steady state
+    float tau_s;
+    float dead_s;
+    float ambient_c;
+    bool  valid;
+} fopdt_model_t;
+
+#define CTRL_IDENT_LAG   16     // Samples spanned by one slope estimate
+
+typedef struct {
+    // Configuration
+    float kp, ki, kd;
+    float dt_s;
+    bool  model_based;
+
+    // Run state
+    ctrl_phase_t  phase;
+    fopdt_model_t model;
+    float setpoint_c;
+    float elapsed_s;
+    float integ;            // Integral term, duty units
+    float prev_temp;
+    float out;              // Last duty, 0..1
+    float switch_s;         // Elapsed time at switch-over
+
+    // Identification: regression of dT/dt on (T - T0)
+    float  hist[CTRL_IDENT_LAG];
+    uint32_t nhist;
+    float  rise_s;          // First time T rose clearly above T0
+    double sx, sy, sxx, sxy;
+    uint32_t n;
+} ctrl_t;
+
+void  ctrl_init(ctrl_t *c, float dt_s, bool model_based);
+void  ctrl_set_gains(ctrl_t *c, float kp, float ki, float kd);
+void  ctrl_start(ctrl_t *c, float setpoint_c, float temp_c);
+void  ctrl_stop(ctrl_t *c);
+float ctrl_step(ctrl_t *c, float temp_c);       // Duty 0..1
+
+// Predicted heat-up time from 'from_c' to 'to_c' at full power,
+// using an identified model; < 0 if unreachable or no model
+float ctrl_model_heat_time(const fopdt_model_t *m, float from_c, float to_c);
@@ -0,0 +1,143 @@
+/*
+ * ============================================================
+ *  Autoklav — flashpartitioner
+ *
+ *  På målet slås partitionen upp i partitionstabellen. På
+ *  Linux-simulatorn används en RAM-buffert som beter sig som
+ *  NOR-flash, så lagringslagren kan köras oförändrade.
+ * ============================================================
+ */
+
+#include "autoclave_flash.h"
+#include <string.h>
+
+#define FLASH_MAX_PARTS 4
+
+static flash_part_t g_parts[FLASH_MAX_PARTS];
+static const char  *g_part_labels[FLASH_MAX_PARTS];
+static int          g_part_count;
+
+static const flash_part_t *find_open(const char *label)
+{
+    for (int i = 0; i < g_part_count; i++)
+        if (strcmp(g_part_labels[i], label) == 0) return &g_parts[i];
+    return NULL;
+}
+
+#ifdef ESP_PLATFORM
+// ═══════════════════════════════════════════════════════════════
+//  ESP-IDF BACKEND
+// ═══════════════════════════════════════════════════════════════
+#include "esp_partition.h"
+
+static bool esp_read(const flash_part_t *p, uint32_t off, void *dst, size_t len)
+{
+    return esp_partition_read(p->ctx, off, dst, len) == ESP_OK;
+}
+
+static bool esp_write(const flash_part_t *p, uint32_t off, const void *src, size_t len)
+{
+    return esp_partition_write(p->ctx, off, src, len) == ESP_OK;
+}
+
+static bool esp_erase(const flash_part_t *p, uint32_t off, size_t len)
+{
+    return esp_partition_erase_range(p->ctx, off, len) == ESP_OK;
+}
+
+const flash_part_t *flash_part_open(const char *label)
+{
+    const flash_part_t *open = find_open(label);
+    if (open) return open;
+    if (g_part_count >= FLASH_MAX_PARTS) return NULL;
+
+    const esp_partition_t *ep = esp_partition_find_first(
+        ESP_PARTITION_TYPE_DATA, ESP_PARTITION_SUBTYPE_ANY, label);
+    if (!ep) return NULL;
+
+    flash_part_t *p = &g_parts[g_part_count];
+    p->read        = esp_read;
+    p->write       = esp_write;
+    p->erase       = esp_erase;
+    p->size        = ep->size;
+    p->sector_size = ep->erase_size;
+    p->ctx         = (void *)ep;
+    g_part_labels[g_part_count++] = label;
+    return p;
+}
+
+#else
+// ═══════════════════════════════════════════════════════════════
+//  HOST BACKEND (simulated NOR flash)
+// ═══════════════════════════════════════════════════════════════
+#include <stdlib.h>
+
+static bool sim_in_range(const flash_part_t *p, uint32_t off, size_t len)
+{
+    return off <= p->size && len <= p->size - off;
+}
+
+static bool sim_read(const flash_part_t *p, uint32_t off, void *dst, size_t len)
+{
+    if (!sim_in_range(p, off, len)) return false;
+    memcpy(dst, (uint8_t *)p->ctx + off, len);
+    return true;
+}
+
+static bool sim_write(const flash_part_t *p, uint32_t off, const void *src, size_t len)
+{
+    if (!sim_in_range(p, off, len)) return false;
+    uint8_t *d = (uint8_t *)p->ctx + off;
+    const uint8_t *s = src;
+    for (size_t i = 0; i < len; i++) d[i] &= s[i];   // NOR: 1 → 0 only
+    return true;
+}
+
+static bool sim_erase(const flash_part_t *p, uint32_t off, size_t len)
+{
+    if (!sim_in_range(p, off, len)) return false;
+    if (off % p->sector_size || len % p->sector_size) return false;
+    memset((uint8_t *)p->ctx + off, 0xFF, len);
+    return true;
+}
+
+const flash_part_t *flash_part_open(const char *label)
+{
+    const flash_part_t *open = find_open(label);
+    if (open) return open;
+    if (g_part_count >= FLASH_MAX_PARTS) return NULL;
+
+    uint8_t *mem = malloc(FLASH_SIM_SIZE);
+    if (!mem) return NULL;
+    memset(mem, 0xFF, FLASH_SIM_SIZE);
+
+    flash_part_t *p = &g_parts[g_part_count];
+    p->read        = sim_read;
+    p->write       = sim_write;
+    p->erase       = sim_erase;
+    p->size        = FLASH_SIM_SIZE;
+    p->sector_size = FLASH_SIM_SECTOR;
+    p->ctx         = mem;
+    g_part_labels[g_part_count++] = label;
+    return p;
+}
+#endif
+
+// ─── CRC-32 (IEEE, nibble table) ─────────────────────────────
+uint32_t flash_crc32(uint32_t crc, const void *data, size_t n)
+{
+    static const uint32_t T[16] = {
+        0x00000000, 0x1DB71064, 0x3B6E20C8, 0x26D930AC,
+        0x76DC4190, 0x6B6B51F4, 0x4DB26158, 0x5005713C,
+        0xEDB88320, 0xF00F9344, 0xD6D6A3E8, 0xCB61B38C,
+        0x9B64C2B0, 0x86D3D2D4, 0xA00AE278, 0xBDBDF21C,
+    };
+    const uint8_t *p = data;
+    crc = ~crc;
+    while (n--) {
+        crc ^= *p++;
+        crc = (crc >> 4) ^ T[crc & 15];
+        crc = (crc >> 4) ^ T[crc & 15];
+    }
+    return ~crc;
+}
@@ -0,0 +1,33 @@
+#pragma once
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+/* ============================================================
+ * Autoclave Control System - raw flash partition access
+ * ESP-IDF: esp_partition by label
+ * Host / simulator: RAM-backed partition with NOR semantics
+ * (erase sets 0xFF, programming can only clear bits)
+ * ============================================================ */
+
+typedef struct flash_part flash_part_t;
+
+struct flash_part {
+    bool (*read)(const flash_part_t *p, uint32_t off, void *dst, size_t len);
+    bool (*write)(const flash_part_t *p, uint32_t off, const void *src, size_t len);
+    bool (*erase)(const flash_part_t *p, uint32_t off, size_t len);
+    uint32_t size;          // Total bytes
+    uint32_t sector_size;   // Erase granularity
+    void *ctx;              // Backend handle
+};
+
+// Host partitions are this big unless the label is already open
+#define FLASH_SIM_SIZE       (64 * 1024)
+#define FLASH_SIM_SECTOR     4096
+
+// Returns NULL if no partition with that label exists
+const flash_part_t *flash_part_open(const char *label);
+
+// CRC-32 (IEEE), chainable: crc = flash_crc32(crc, data, n), start with 0
+uint32_t flash_crc32(uint32_t crc, const void *data, size_t n);
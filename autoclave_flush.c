@@ -0,0 +1,161 @@
+/*
+ * ============================================================
+ *  Autoklav — hoppa över oförändrade flush-ytor
+ *
+ *  Varje band (16 rader) minns de senast skickade segmenten
+ *  med exakt rektangel och 64-bitars hash. Ett segment hoppas
+ *  över bara om rektangeln matchar en post och hashen är lika;
+ *  allt som skickas ersätter de poster det överlappar, så en
+ *  post beskriver alltid vad panelen faktiskt visar.
+ * ============================================================
+ */
+
+#include "autoclave_flush.h"
+#include <string.h>
+
+#define BANDS           (FLUSH_ELIDE_MAX_H / FLUSH_ELIDE_BAND_ROWS)
+#define FNV_OFFSET      0xcbf29ce484222325ull
+#define FNV_PRIME       0x100000001b3ull
+
+typedef struct {
+    uint16_t x1, x2, y1, y2;
+    uint64_t hash;
+    bool     used;
+} seg_entry_t;
+
+static seg_entry_t g_tab[BANDS][FLUSH_ELIDE_WAYS];
+static uint8_t     g_victim[BANDS];
+static uint16_t    g_ver_res;
+static uint8_t     g_bpp;
+static bool        g_enabled;
+static flush_elide_stats_t g_stats;
+
+// FNV-1a over 32-bit words, rows of 'row_bytes' at 'stride'
+static uint64_t hash_rows(const uint8_t *p, size_t row_bytes, size_t stride, int rows)
+{
+    uint64_t h = FNV_OFFSET;
+    for (int r = 0; r < rows; r++, p += stride) {
+        size_t i = 0;
+        for (; i + 4 <= row_bytes; i += 4) {
+            uint32_t w;
+            memcpy(&w, p + i, 4);
+            h = (h ^ w) * FNV_PRIME;
+        }
+        for (; i < row_bytes; i++) h = (h ^ p[i]) * FNV_PRIME;
+    }
+    return h;
+}
+
+// True if the panel already shows these pixels; otherwise records them
+static bool seg_unchanged(int band, int x1, int y1, int x2, int y2, uint64_t hash)
+{
+    seg_entry_t *set = g_tab[band];
+    int free_slot = -1;
+    for (int i = 0; i < FLUSH_ELIDE_WAYS; i++) {
+        seg_entry_t *e = &set[i];
+        if (!e->used) {
+            if (free_slot < 0) free_slot = i;
+            continue;
+        }
+        if (e->x1 == x1 && e->x2 == x2 && e->y1 == y1 && e->y2 == y2) {
+            if (e->hash == hash) return true;
+            e->hash = hash;
+            // Exact geometry cannot overlap another entry, nothing else to drop
+            return false;
+        }
+        if (e->x1 <= x2 && x1 <= e->x2 && e->y1 <= y2 && y1 <= e->y2) {
+            e->used = false;                // Overwritten on the panel
+            if (free_slot < 0) free_slot = i;
+        }
+    }
+    if (free_slot < 0) {
+        free_slot = g_victim[band];
+        g_victim[band] = (uint8_t)((g_victim[band] + 1) % FLUSH_ELIDE_WAYS);
+    }
+    set[free_slot] = (seg_entry_t){ (uint16_t)x1, (uint16_t)x2, (uint16_t)y1, (uint16_t)y2,
+                                    hash, true };
+    return false;
+}
+
+bool flush_elide_init(uint16_t ver_res, uint8_t bytes_per_px)
+{
+    if (ver_res > FLUSH_ELIDE_MAX_H || bytes_per_px == 0) return false;
+    g_ver_res = ver_res;
+    g_bpp = bytes_per_px;
+    flush_elide_reset();
+    flush_elide_reset_stats();
+    return true;
+}
+
+void flush_elide_enable(bool on)
+{
+    if (on && !g_enabled) flush_elide_reset();
+    g_enabled = on;
+}
+
+bool flush_elide_is_enabled(void)
+{
+    return g_enabled;
+}
+
+void flush_elide_reset(void)
+{
+    memset(g_tab, 0, sizeof(g_tab));
+    memset(g_victim, 0, sizeof(g_victim));
+}
+
+size_t flush_elide_process(int x1, int y1, int x2, int y2, const uint8_t *px,
+                           flush_send_cb_t send, void *user)
+{
+    size_t stride = (size_t)(x2 - x1 + 1) * g_bpp;
+    uint64_t area_bytes = stride * (uint64_t)(y2 - y1 + 1);
+
+    if (!g_enabled || g_bpp == 0 || y2 >= g_ver_res) {
+        send(x1, y1, x2, y2, px, user);
+        g_stats.segments_sent++;
+        g_stats.transfers++;
+        g_stats.bytes_sent += area_bytes;
+        return 1;
+    }
+
+    size_t transfers = 0;
+    int run_y = -1;                         // First row of the pending send run
+    for (int y = y1; y <= y2; ) {
+        int band = y / FLUSH_ELIDE_BAND_ROWS;
+        int ye = (band + 1) * FLUSH_ELIDE_BAND_ROWS - 1;
+        if (ye > y2) ye = y2;
+        const uint8_t *p = px + (size_t)(y - y1) * stride;
+        uint64_t bytes = stride * (uint64_t)(ye - y + 1);
+
+        if (seg_unchanged(band, x1, y, x2, ye, hash_rows(p, stride, stride, ye - y + 1))) {
+            g_stats.segments_elided++;
+            g_stats.bytes_elided += bytes;
+            if (run_y >= 0) {
+                send(x1, run_y, x2, y - 1, px + (size_t)(run_y - y1) * stride, user);
+                transfers++;
+                run_y = -1;
+            }
+        } else {
+            g_stats.segments_sent++;
+            g_stats.bytes_sent += bytes;
+            if (run_y < 0) run_y = y;
+        }
+        y = ye + 1;
+    }
+    if (run_y >= 0) {
+        send(x1, run_y, x2, y2, px + (size_t)(run_y - y1) * stride, user);
+        transfers++;
+    }
+    g_stats.transfers += (uint32_t)transfers;
+    return transfers;
+}
+
+void flush_elide_get_stats(flush_elide_stats_t *out)
+{
+    *out = g_stats;
+}
+
+void flush_elide_reset_stats(void)
+{
+    memset(&g_stats, 0, sizeof(g_stats));
+}
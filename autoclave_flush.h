@@ -0,0 +1,64 @@
+#pragma once
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+/* ============================================================
+ * Autoclave Control System - flush elision
+ * Optional stage in the display flush path. Each rendered area
+ * is cut into segments on a fixed 16-row grid; a segment whose
+ * pixels hash the same as what was last sent for exactly that
+ * rectangle is not transferred. Segments are full area width, so
+ * every run of changed segments is still one contiguous buffer.
+ *
+ * ui_init() calls flush_elide_init() and switches elision from
+ * the persisted setting (ui_set_flush_elision()); while it is
+ * off every area goes straight through. The board flush path:
+ *
+ *   static void panel_send(int x1, int y1, int x2, int y2,
+ *                          const uint8_t *px, void *user)
+ *   {
+ *       esp_lcd_panel_draw_bitmap(panel, x1, y1, x2 + 1, y2 + 1, px);
+ *       pending++;                      // Completion ISR decrements
+ *   }
+ *
+ *   static void board_flush_cb(lv_display_t *disp, const lv_area_t *area,
+ *                              uint8_t *px_map)
+ *   {
+ *       remote_view_on_flush(...);      // Optional, autoclave_remote.h
+ *       if (flush_elide_process(area->x1, area->y1, area->x2, area->y2,
+ *                               px_map, panel_send, disp) == 0)
+ *           lv_display_flush_ready(disp);
+ *   }
+ *
+ * and call lv_display_flush_ready() once the last transfer of
+ * the call completes (the return value is the transfer count).
+ * ============================================================ */
+
+#define FLUSH_ELIDE_BAND_ROWS   16
+#define FLUSH_ELIDE_MAX_H       1024
+#define FLUSH_ELIDE_WAYS        4       // Remembered segments per band
+
+// Transfers rows y1..y2 of x1..x2; px is contiguous, row stride = width
+typedef void (*flush_send_cb_t)(int x1, int y1, int x2, int y2,
+                                const uint8_t *px, void *user);
+
+typedef struct {
+    uint32_t segments_sent;
+    uint32_t segments_elided;
+    uint32_t transfers;
+    uint64_t bytes_sent;
+    uint64_t bytes_elided;
+} flush_elide_stats_t;
+
+bool   flush_elide_init(uint16_t ver_res, uint8_t bytes_per_px);
+void   flush_elide_enable(bool on);      // Off: every area is sent whole
+bool   flush_elide_is_enabled(void);
+void   flush_elide_reset(void);          // Forget all hashes (panel contents unknown)
+
+size_t flush_elide_process(int x1, int y1, int x2, int y2, const uint8_t *px,
+                           flush_send_cb_t send, void *user);
+
+void   flush_elide_get_stats(flush_elide_stats_t *out);
+void   flush_elide_reset_stats(void);
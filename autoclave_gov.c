@@ -0,0 +1,129 @@
+/*
+ * ============================================================
+ *  Autoklav — uppdateringsregulator
+ *
+ *  Nivån beräknas om vid varje händelse och i gov_step(): den
+ *  senaste aktiviteten (beröring, animation, brådskande
+ *  ändring) håller ACTIVE i GOV_ACTIVE_HOLD_MS, den senaste
+ *  beröringen eller larmändringen håller bakgrundsljuset uppe
+ *  till tidsgränsen. Tiden i varje nivå räknas när nivån byts.
+ * ============================================================
+ */
+
+#include "autoclave_gov.h"
+#include <string.h>
+
+static const gov_profile_t PROFILES[GOV_LEVELS] = {
+    [GOV_ACTIVE] = { .refr_ms = 33,  .update_ms = 50,  .indev_ms = 30,  .backlight_pct = 100 },
+    [GOV_IDLE]   = { .refr_ms = 250, .update_ms = 250, .indev_ms = 60,  .backlight_pct = 100 },
+    [GOV_DIM]    = { .refr_ms = 500, .update_ms = 500, .indev_ms = 100, .backlight_pct = 15 },
+};
+
+static gov_apply_cb_t g_apply;
+static gov_level_t    g_level;
+static uint32_t       g_dim_ms = GOV_DIM_DEFAULT_MS;
+static uint32_t       g_last_active;        // Input, animation or urgent change
+static uint32_t       g_last_wake;          // Input or urgent change
+static uint32_t       g_level_since;
+static gov_stats_t    g_stats;
+
+// Timer runs per second at a profile, ×1000; the urgent poll runs
+// at the touch read rate
+static uint32_t wake_rate(const gov_profile_t *p)
+{
+    return 1000000u / p->refr_ms + 1000000u / p->update_ms + 2 * (1000000u / p->indev_ms);
+}
+
+static void account(uint32_t now)
+{
+    g_stats.ms[g_level] += now - g_level_since;
+    g_level_since = now;
+}
+
+static gov_level_t set_level(gov_level_t l, uint32_t now)
+{
+    if (l == g_level) return l;
+    account(now);
+    g_level = l;
+    g_stats.switches++;
+    if (g_apply) g_apply(l, &PROFILES[l]);
+    return l;
+}
+
+static gov_level_t evaluate(uint32_t now)
+{
+    if (now - g_last_active < GOV_ACTIVE_HOLD_MS) return set_level(GOV_ACTIVE, now);
+    if (g_dim_ms && now - g_last_wake >= g_dim_ms) return set_level(GOV_DIM, now);
+    return set_level(GOV_IDLE, now);
+}
+
+void gov_init(gov_apply_cb_t apply, uint32_t now_ms)
+{
+    g_apply = apply;
+    g_level = GOV_ACTIVE;
+    g_last_active = g_last_wake = g_level_since = now_ms;
+    memset(&g_stats, 0, sizeof(g_stats));
+    if (g_apply) g_apply(g_level, &PROFILES[g_level]);
+}
+
+void gov_set_dim_timeout(uint32_t ms)
+{
+    g_dim_ms = ms;
+}
+
+const gov_profile_t *gov_profile(gov_level_t level)
+{
+    return &PROFILES[level < GOV_LEVELS ? level : GOV_ACTIVE];
+}
+
+gov_level_t gov_level(void)
+{
+    return g_level;
+}
+
+gov_level_t gov_note_input(uint32_t now_ms)
+{
+    g_last_active = g_last_wake = now_ms;
+    return evaluate(now_ms);
+}
+
+gov_level_t gov_note_urgent(uint32_t now_ms)
+{
+    g_stats.urgent++;
+    g_last_active = g_last_wake = now_ms;
+    return evaluate(now_ms);
+}
+
+gov_level_t gov_step(uint32_t now_ms, bool animating)
+{
+    if (animating) g_last_active = now_ms;
+    return evaluate(now_ms);
+}
+
+void gov_note_frame(uint32_t render_us)
+{
+    g_stats.frames[g_level]++;
+    g_stats.render_us[g_level] += render_us;
+}
+
+void gov_get_stats(uint32_t now_ms, gov_stats_t *out)
+{
+    account(now_ms);
+    *out = g_stats;
+
+    uint64_t wake = 0, light = 0, total = 0;
+    for (int l = 0; l < GOV_LEVELS; l++) {
+        wake  += (uint64_t)g_stats.ms[l] * wake_rate(&PROFILES[l]);
+        light += (uint64_t)g_stats.ms[l] * PROFILES[l].backlight_pct;
+        total += g_stats.ms[l];
+    }
+    out->wakeups = (uint32_t)(wake / 1000000u);
+    out->wakeups_full = (uint32_t)(total * wake_rate(&PROFILES[GOV_ACTIVE]) / 1000000u);
+    out->backlight_pct_avg = total ? (uint32_t)(light / total) : PROFILES[g_level].backlight_pct;
+}
+
+void gov_reset_stats(uint32_t now_ms)
+{
+    memset(&g_stats, 0, sizeof(g_stats));
+    g_level_since = now_ms;
+}
@@ -0,0 +1,69 @@
+#pragma once
+
+#include <stdbool.h>
+#include <stdint.h>
+
+/* ============================================================
+ * Autoclave Control System - refresh governor
+ * Picks how often the UI runs from what is actually happening:
+ *   ACTIVE  touch, a running animation or an urgent change in
+ *           the last GOV_ACTIVE_HOLD_MS: full rate
+ *   IDLE    only live values change: slow refresh, backlight on
+ *   DIM     no touch for the dim timeout: slowest, backlight low
+ * Each level is a profile of timer periods; the UI applies it
+ * (display refresh, widget update, touch read) in the callback.
+ *
+ * Urgent changes (alarms) switch to ACTIVE at once and restore
+ * the backlight. Other tasks only raise a flag; the UI polls it
+ * on the LVGL thread at indev_ms, notes it here and makes its
+ * update and refresh timers ready, so an urgent change starts
+ * rendering within GOV_ALARM_LATENCY_MS at any level: one poll
+ * (never longer than the slowest indev_ms, 100 ms) plus one
+ * pass at the ACTIVE rates.
+ * ============================================================ */
+
+#define GOV_ACTIVE_HOLD_MS       2000
+#define GOV_DIM_DEFAULT_MS       (5 * 60 * 1000)
+#define GOV_ALARM_LATENCY_MS     150
+
+typedef enum {
+    GOV_ACTIVE,
+    GOV_IDLE,
+    GOV_DIM,
+    GOV_LEVELS
+} gov_level_t;
+
+typedef struct {
+    uint16_t refr_ms;           // Display refresh timer
+    uint16_t update_ms;         // Widget update (chamber flush) timer
+    uint16_t indev_ms;          // Touch read timer
+    uint8_t  backlight_pct;
+} gov_profile_t;
+
+typedef void (*gov_apply_cb_t)(gov_level_t level, const gov_profile_t *p);
+
+typedef struct {
+    uint32_t ms[GOV_LEVELS];    // Time spent per level
+    uint32_t frames[GOV_LEVELS];
+    uint64_t render_us[GOV_LEVELS];
+    uint32_t switches;
+    uint32_t urgent;
+    uint32_t wakeups;           // Timer runs at the chosen periods
+    uint32_t wakeups_full;      // Same time at the ACTIVE profile
+    uint32_t backlight_pct_avg; // Time-weighted
+} gov_stats_t;
+
+void gov_init(gov_apply_cb_t apply, uint32_t now_ms);
+void gov_set_dim_timeout(uint32_t ms);          // 0 = never dim
+const gov_profile_t *gov_profile(gov_level_t level);
+gov_level_t gov_level(void);
+
+// Events; each returns the level afterwards (applied if it changed)
+gov_level_t gov_note_input(uint32_t now_ms);
+gov_level_t gov_note_urgent(uint32_t now_ms);
+// Periodic; 'animating' = any animation still running
+gov_level_t gov_step(uint32_t now_ms, bool animating);
+
+void gov_note_frame(uint32_t render_us);
+void gov_get_stats(uint32_t now_ms, gov_stats_t *out);
+void gov_reset_stats(uint32_t now_ms);
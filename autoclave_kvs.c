@@ -0,0 +1,267 @@
+/*
+ * ============================================================
+ *  Autoklav — inställningslagring (logg-strukturerad)
+ *
+ *  Sektorlayout:
+ *    [sect_hdr_t][rec_hdr_t|data|pad][rec_hdr_t|data|pad]...[0xFF...]
+ *
+ *  Sektorerna används som en ring. Huvudsektorn har högst
+ *  sekvensnummer; sektorn efter huvudet är alltid ledig. När
+ *  huvudet flyttas fram kopieras de levande posterna i den
+ *  äldsta sektorn till det nya huvudet innan den raderas.
+ * ============================================================
+ */
+
+#include "autoclave_kvs.h"
+#include <string.h>
+
+#define KVS_MAGIC       0x31564B41u     // "AKV1"
+#define KEY_ERASED      0xFFFF
+
+typedef struct {
+    uint32_t magic;
+    uint32_t seq;
+    uint32_t seq_inv;       // ~seq, rejects a half-written header
+    uint32_t reserved;
+} sect_hdr_t;
+
+typedef struct {
+    uint16_t key;
+    uint16_t len;
+    uint32_t crc;           // CRC-32 over key, len and data
+} rec_hdr_t;
+
+typedef struct {
+    uint16_t key;
+    uint8_t  sector;
+    uint8_t  len;
+    uint16_t off;           // Record header offset within the sector
+    uint32_t crc;
+} kvs_idx_t;
+
+#define REC_SIZE(len)   ((uint32_t)(sizeof(rec_hdr_t) + (((len) + 3u) & ~3u)))
+#define LIVE_MAX        (KVS_MAX_KEYS * REC_SIZE(KVS_MAX_VALUE))
+
+static const flash_part_t *g_part;
+static uint32_t  g_nsec;
+static uint32_t  g_ssize;
+static uint32_t  g_seq[KVS_MAX_SECTORS];       // 0 = free sector
+static uint32_t  g_head;
+static uint32_t  g_head_off;
+static kvs_idx_t g_idx[KVS_MAX_KEYS];
+static uint32_t  g_nkeys;
+static kvs_stats_t g_stats;
+
+static uint8_t g_scan_buf[KVS_SECTOR_MAX];
+static uint32_t g_rec_buf[REC_SIZE(KVS_MAX_VALUE) / 4];
+
+static uint32_t rec_crc(uint16_t key, uint16_t len, const void *data)
+{
+    uint16_t kl[2] = { key, len };
+    return flash_crc32(flash_crc32(0, kl, sizeof(kl)), data, len);
+}
+
+// ─── RAM index ───────────────────────────────────────────────
+static kvs_idx_t *idx_find(uint16_t key)
+{
+    for (uint32_t i = 0; i < g_nkeys; i++)
+        if (g_idx[i].key == key) return &g_idx[i];
+    return NULL;
+}
+
+static void idx_put(const rec_hdr_t *r, uint32_t sector, uint32_t off)
+{
+    kvs_idx_t *e = idx_find(r->key);
+    if (!e) {
+        if (g_nkeys >= KVS_MAX_KEYS) return;
+        e = &g_idx[g_nkeys++];
+        e->key = r->key;
+    }
+    e->sector = (uint8_t)sector;
+    e->len    = (uint8_t)r->len;
+    e->off    = (uint16_t)off;
+    e->crc    = r->crc;
+}
+
+// ─── Sector helpers ──────────────────────────────────────────
+static uint32_t sector_base(uint32_t s) { return s * g_ssize; }
+
+static bool sector_open(uint32_t s, uint32_t seq)
+{
+    sect_hdr_t h = { KVS_MAGIC, seq, ~seq, 0xFFFFFFFFu };
+    if (!g_part->erase(g_part, sector_base(s), g_ssize)) return false;
+    if (!g_part->write(g_part, sector_base(s), &h, sizeof(h))) return false;
+    g_seq[s] = seq;
+    return true;
+}
+
+// Reads the whole sector once and indexes every intact record.
+// Returns the offset where the next record may be appended.
+static uint32_t sector_scan(uint32_t s)
+{
+    if (!g_part->read(g_part, sector_base(s), g_scan_buf, g_ssize))
+        return g_ssize;
+
+    uint32_t off = sizeof(sect_hdr_t);
+    while (off + sizeof(rec_hdr_t) <= g_ssize) {
+        rec_hdr_t r;
+        memcpy(&r, g_scan_buf + off, sizeof(r));
+        if (r.key == KEY_ERASED) break;
+        if (r.len > KVS_MAX_VALUE || off + REC_SIZE(r.len) > g_ssize ||
+            rec_crc(r.key, r.len, g_scan_buf + off + sizeof(r)) != r.crc)
+            return g_ssize;                       // Torn write: seal the sector
+        idx_put(&r, s, off);
+        off += REC_SIZE(r.len);
+    }
+
+    // Anything programmed past the end marker is a torn write too
+    for (uint32_t i = off; i < g_ssize; i++)
+        if (g_scan_buf[i] != 0xFF) return g_ssize;
+    return off;
+}
+
+static bool append(const void *rec, uint32_t size)
+{
+    if (g_head_off + size > g_ssize) return false;
+    if (!g_part->write(g_part, sector_base(g_head) + g_head_off, rec, size)) {
+        g_head_off = g_ssize;                     // Don't program over it again
+        return false;
+    }
+    rec_hdr_t r;
+    memcpy(&r, rec, sizeof(r));
+    idx_put(&r, g_head, g_head_off);
+    g_head_off += size;
+    g_stats.writes++;
+    return true;
+}
+
+// Moves the live records of 'victim' into the head and erases it
+static bool move_out(uint32_t victim)
+{
+    for (uint32_t i = 0; i < g_nkeys; i++) {
+        if (g_idx[i].sector != victim) continue;
+        uint32_t size = REC_SIZE(g_idx[i].len);
+        if (!g_part->read(g_part, sector_base(victim) + g_idx[i].off,
+                          g_rec_buf, size))
+            return false;
+        if (!append(g_rec_buf, size)) return false;
+    }
+    if (!g_part->erase(g_part, sector_base(victim), g_ssize)) return false;
+    g_seq[victim] = 0;
+    return true;
+}
+
+static bool compact(uint32_t victim)
+{
+    bool ok = move_out(victim);
+    if (ok) g_stats.compactions++;
+    else    g_stats.compact_failed++;
+    return ok;
+}
+
+static bool advance(void)
+{
+    uint32_t next = (g_head + 1) % g_nsec;
+    if (g_seq[next] && !compact(next)) return false;
+    if (!sector_open(next, g_seq[g_head] + 1)) return false;
+    g_head = next;
+    g_head_off = sizeof(sect_hdr_t);
+
+    // Keep the sector after the head free for the next rotation
+    uint32_t after = (next + 1) % g_nsec;
+    return g_seq[after] ? compact(after) : true;
+}
+
+// ═══════════════════════════════════════════════════════════════
+//  PUBLIC API
+// ═══════════════════════════════════════════════════════════════
+bool kvs_init(const flash_part_t *part)
+{
+    g_part = NULL;
+    g_nkeys = 0;
+    memset(&g_stats, 0, sizeof(g_stats));
+    if (!part || part->sector_size > KVS_SECTOR_MAX) return false;
+    if (part->sector_size < sizeof(sect_hdr_t) + LIVE_MAX + REC_SIZE(KVS_MAX_VALUE))
+        return false;                             // Compaction could overflow
+
+    g_part  = part;
+    g_ssize = part->sector_size;
+    g_nsec  = part->size / part->sector_size;
+    if (g_nsec > KVS_MAX_SECTORS) g_nsec = KVS_MAX_SECTORS;
+    if (g_nsec < 2) { g_part = NULL; return false; }
+
+    // Pass 1: sector headers
+    uint32_t order[KVS_MAX_SECTORS];
+    uint32_t nvalid = 0;
+    for (uint32_t s = 0; s < g_nsec; s++) {
+        sect_hdr_t h;
+        g_seq[s] = 0;
+        if (!part->read(part, sector_base(s), &h, sizeof(h))) continue;
+        if (h.magic != KVS_MAGIC || h.seq_inv != ~h.seq || h.seq == 0) continue;
+        g_seq[s] = h.seq;
+        // Insertion sort, oldest first
+        uint32_t j = nvalid++;
+        while (j > 0 && g_seq[order[j - 1]] > h.seq) { order[j] = order[j - 1]; j--; }
+        order[j] = s;
+    }
+
+    if (nvalid == 0) {
+        if (!sector_open(0, 1)) { g_part = NULL; return false; }
+        g_head = 0;
+        g_head_off = sizeof(sect_hdr_t);
+    } else {
+        // Pass 2: one sequential read per sector, newest record wins
+        for (uint32_t i = 0; i < nvalid; i++)
+            g_head_off = sector_scan(order[i]);
+        g_head = order[nvalid - 1];
+    }
+
+    // An interrupted compaction leaves the sector after the head in use
+    uint32_t after = (g_head + 1) % g_nsec;
+    return g_seq[after] ? compact(after) : true;
+}
+
+size_t kvs_get(uint16_t key, void *buf, size_t cap)
+{
+    if (!g_part) return 0;
+    const kvs_idx_t *e = idx_find(key);
+    if (!e) return 0;
+    size_t n = e->len < cap ? e->len : cap;
+    uint32_t addr = sector_base(e->sector) + e->off + sizeof(rec_hdr_t);
+    if (!g_part->read(g_part, addr, buf, n)) return 0;
+    return e->len;
+}
+
+bool kvs_set(uint16_t key, const void *val, size_t len)
+{
+    if (!g_part || key == KEY_ERASED || len > KVS_MAX_VALUE) return false;
+
+    rec_hdr_t r = { key, (uint16_t)len, rec_crc(key, (uint16_t)len, val) };
+    const kvs_idx_t *e = idx_find(key);
+    if (e && e->len == len && e->crc == r.crc) {
+        uint8_t cur[KVS_MAX_VALUE];
+        if (kvs_get(key, cur, sizeof(cur)) == len && memcmp(cur, val, len) == 0) {
+            g_stats.skipped++;
+            return true;                          // Unchanged: spare the flash
+        }
+    }
+    if (!e && g_nkeys >= KVS_MAX_KEYS) return false;
+
+    uint32_t size = REC_SIZE(len);
+    if (g_head_off + size > g_ssize && !advance()) return false;
+
+    uint8_t *rec = (uint8_t *)g_rec_buf;
+    memset(rec, 0xFF, size);
+    memcpy(rec, &r, sizeof(r));
+    memcpy(rec + sizeof(r), val, len);
+    return append(g_rec_buf, size);
+}
+
+void kvs_get_stats(kvs_stats_t *out)
+{
+    g_stats.sectors    = g_nsec;
+    g_stats.generation = g_part ? g_seq[g_head] : 0;
+    g_stats.head_used  = g_head_off;
+    g_stats.live_keys  = g_nkeys;
+    *out = g_stats;
+}
@@ -0,0 +1,36 @@
+#pragma once
+
+#include "autoclave_flash.h"
+
+/* ============================================================
+ * Autoclave Control System - settings key/value store
+ * Append-only log over a ring of flash sectors:
+ *   - every record is CRC-32 protected, a torn write is ignored
+ *     and the previous value stays in effect
+ *   - the oldest sector is compacted into the head before it is
+ *     erased, so sectors wear evenly
+ *   - boot rebuilds the RAM index with one read per sector
+ * ============================================================ */
+
+#define KVS_MAX_KEYS         32
+#define KVS_MAX_VALUE        64      // Bytes per value
+#define KVS_MAX_SECTORS      16
+#define KVS_SECTOR_MAX       4096    // Largest supported erase size
+
+typedef struct {
+    uint32_t sectors;       // Sectors in the ring
+    uint32_t generation;    // Sequence number of the head sector
+    uint32_t head_used;     // Bytes written in the head sector
+    uint32_t live_keys;
+    uint32_t writes;        // Records appended since boot
+    uint32_t skipped;       // kvs_set() calls with an unchanged value
+    uint32_t compactions;   // Sectors reclaimed since boot
+    uint32_t compact_failed;// Compactions that could not finish
+} kvs_stats_t;
+
+// false: nothing readable, or the compaction interrupted by the last
+// reset could not be finished (values read are valid, writes may fail)
+bool   kvs_init(const flash_part_t *part);
+size_t kvs_get(uint16_t key, void *buf, size_t cap);   // Stored length, 0 if absent
+bool   kvs_set(uint16_t key, const void *val, size_t len);
+void   kvs_get_stats(kvs_stats_t *out);
@@ -0,0 +1,352 @@
+/*
+ * ============================================================
+ *  Autoklav — fjärrvisning
+ *
+ *  Flush-taskens yta komprimeras direkt in i en sändring (en
+ *  "bip-buffer": varje post ligger sammanhängande, och slutet
+ *  av ringen hoppas över när en post inte får plats där). En
+ *  producent (flush) och en konsument (sändaren) delar bara
+ *  head/tail/end, så ingen lås behövs.
+ * ============================================================
+ */
+
+#include "autoclave_remote.h"
+#include <errno.h>
+#include <stdlib.h>
+#include <string.h>
+
+#ifdef ESP_PLATFORM
+#include "lwip/sockets.h"
+#include "esp_heap_caps.h"
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+#define SENDER_PERIOD_MS    10
+#define SEND_FLAGS          0
+#else
+#include <fcntl.h>
+#include <netinet/in.h>
+#include <sys/socket.h>
+#include <unistd.h>
+#define SEND_FLAGS          MSG_NOSIGNAL
+#endif
+
+#define AREA_HDR_SIZE       16
+#define HELLO_SIZE          12
+#define RUN_MAX             128
+
+static uint8_t  *g_ring;
+static uint32_t  g_head;            // Producer
+static uint32_t  g_tail;            // Consumer
+static uint32_t  g_end;             // Data end before a wrap, valid while head < tail
+static int       g_listen = -1;
+static int       g_client = -1;
+static uint16_t  g_port;
+static uint16_t  g_width, g_height;
+static volatile bool g_connected;
+static volatile bool g_resync;
+static remote_stats_t g_stats;
+
+// ═══════════════════════════════════════════════════════════════
+//  CODEC
+// ═══════════════════════════════════════════════════════════════
+static inline void put16(uint8_t *p, uint16_t v) { p[0] = (uint8_t)v; p[1] = (uint8_t)(v >> 8); }
+static inline void put32(uint8_t *p, uint32_t v) { put16(p, (uint16_t)v); put16(p + 2, (uint16_t)(v >> 16)); }
+static inline uint16_t get16(const uint8_t *p) { return (uint16_t)(p[0] | p[1] << 8); }
+
+size_t remote_rle_encode(const uint16_t *px, size_t n, uint8_t *out, size_t cap)
+{
+    size_t o = 0, i = 0;
+    while (i < n) {
+        // Length of the run starting at i
+        size_t r = 1;
+        while (i + r < n && r < RUN_MAX && px[i + r] == px[i]) r++;
+        if (r >= 2) {
+            if (o + 3 > cap) return 0;
+            out[o++] = (uint8_t)(0x80 | (r - 1));
+            put16(out + o, px[i]);
+            o += 2;
+            i += r;
+            continue;
+        }
+        // Literals until the next run of two or more
+        size_t l = 1;
+        while (i + l < n && l < RUN_MAX &&
+               !(i + l + 1 < n && px[i + l] == px[i + l + 1])) l++;
+        if (o + 1 + 2 * l > cap) return 0;
+        out[o++] = (uint8_t)(l - 1);
+        for (size_t k = 0; k < l; k++, o += 2) put16(out + o, px[i + k]);
+        i += l;
+    }
+    return o;
+}
+
+size_t remote_rle_decode(const uint8_t *in, size_t len, uint16_t *px, size_t n)
+{
+    size_t i = 0, o = 0;
+    while (i < len) {
+        uint8_t c = in[i++];
+        size_t cnt = (size_t)(c & 0x7F) + 1;
+        if (o + cnt > n) return 0;
+        if (c & 0x80) {
+            if (i + 2 > len) return 0;
+            uint16_t v = get16(in + i);
+            i += 2;
+            for (size_t k = 0; k < cnt; k++) px[o++] = v;
+        } else {
+            if (i + 2 * cnt > len) return 0;
+            for (size_t k = 0; k < cnt; k++, i += 2) px[o++] = get16(in + i);
+        }
+    }
+    return o;
+}
+
+// ═══════════════════════════════════════════════════════════════
+//  PRODUCER (flush)
+// ═══════════════════════════════════════════════════════════════
+// Encodes one area at ring offset 'at' with at most 'cap' bytes
+static uint32_t encode_area(uint32_t at, uint32_t cap, const uint16_t hdr[4],
+                            const uint16_t *px, size_t n, bool last)
+{
+    if (cap <= AREA_HDR_SIZE) return 0;
+    uint8_t *h = g_ring + at;
+    uint8_t *body = h + AREA_HDR_SIZE;
+    size_t room = cap - AREA_HDR_SIZE;
+    size_t raw = n * 2;
+
+    uint8_t codec = REMOTE_CODEC_RLE;
+    size_t len = remote_rle_encode(px, n, body, room < raw ? room : raw);
+    if (len == 0) {
+        if (raw > room) return 0;
+        codec = REMOTE_CODEC_RAW;
+        memcpy(body, px, raw);
+        len = raw;
+    }
+
+    for (int k = 0; k < 4; k++) put16(h + 2 * k, hdr[k]);
+    h[8] = codec;
+    h[9] = last ? REMOTE_FLAG_LAST : 0;
+    put16(h + 10, 0);
+    put32(h + 12, (uint32_t)len);
+    return AREA_HDR_SIZE + (uint32_t)len;
+}
+
+void remote_view_on_flush(int x1, int y1, int x2, int y2,
+                          const uint16_t *px, bool last)
+{
+    if (!g_connected || !g_ring) return;
+    if (x1 < 0 || y1 < 0 || x2 >= g_width || y2 >= g_height || x2 < x1 || y2 < y1)
+        return;
+
+    const uint16_t hdr[4] = { (uint16_t)x1, (uint16_t)y1, (uint16_t)x2, (uint16_t)y2 };
+    size_t n = (size_t)(x2 - x1 + 1) * (size_t)(y2 - y1 + 1);
+    uint32_t head = g_head;
+    uint32_t tail = __atomic_load_n(&g_tail, __ATOMIC_ACQUIRE);
+
+    g_stats.areas++;
+    g_stats.raw_bytes += n * 2;
+
+    uint32_t used;
+    if (head >= tail) {
+        // Free: [head, SIZE) then [0, tail - 1)
+        uint32_t cap = REMOTE_RING_SIZE - head - (tail == 0 ? 1 : 0);
+        used = encode_area(head, cap, hdr, px, n, last);
+        if (used) {
+            head += used;
+            if (head == REMOTE_RING_SIZE) {
+                g_end = REMOTE_RING_SIZE;
+                head = 0;
+            }
+        } else if (tail > 1 && (used = encode_area(0, tail - 1, hdr, px, n, last))) {
+            g_end = head;
+            head = used;
+        }
+    } else {
+        used = encode_area(head, tail - head - 1, hdr, px, n, last);
+        head += used;
+    }
+
+    if (!used) {
+        g_stats.dropped++;
+        g_resync = true;
+        return;
+    }
+    __atomic_store_n(&g_head, head, __ATOMIC_RELEASE);
+}
+
+bool remote_view_take_resync(void)
+{
+    if (!g_resync) return false;
+    g_resync = false;
+    g_stats.resyncs++;
+    return true;
+}
+
+// ═══════════════════════════════════════════════════════════════
+//  CONSUMER (sender)
+// ═══════════════════════════════════════════════════════════════
+static void close_client(void)
+{
+    if (g_client >= 0) close(g_client);
+    g_client = -1;
+    g_connected = false;
+}
+
+static bool send_all(const uint8_t *p, size_t len)
+{
+    while (len) {
+        ssize_t k = send(g_client, p, len, SEND_FLAGS);
+        if (k < 0 && (errno == EAGAIN || errno == EWOULDBLOCK)) continue;
+        if (k <= 0) return false;
+        p += k;
+        len -= (size_t)k;
+    }
+    return true;
+}
+
+static void accept_client(void)
+{
+    int fd = accept(g_listen, NULL, NULL);
+    if (fd < 0) return;
+    if (g_client >= 0) {
+        close(fd);                  // One viewer at a time
+        return;
+    }
+    g_client = fd;
+
+    uint8_t hello[HELLO_SIZE];
+    put32(hello, REMOTE_MAGIC);
+    put16(hello + 4, g_width);
+    put16(hello + 6, g_height);
+    hello[8] = REMOTE_VERSION;
+    hello[9] = REMOTE_FORMAT_RGB565;
+    put16(hello + 10, 0);
+    if (!send_all(hello, sizeof(hello))) {
+        close_client();
+        return;
+    }
+    fcntl(fd, F_SETFL, fcntl(fd, F_GETFL, 0) | O_NONBLOCK);
+
+    // Drop whatever was queued for a previous viewer, then redraw
+    __atomic_store_n(&g_tail, __atomic_load_n(&g_head, __ATOMIC_ACQUIRE), __ATOMIC_RELEASE);
+    g_connected = true;
+    g_resync = true;
+}
+
+void remote_view_poll(void)
+{
+    if (g_listen < 0) return;
+    accept_client();
+    if (g_client < 0) return;
+
+    for (;;) {
+        uint32_t head = __atomic_load_n(&g_head, __ATOMIC_ACQUIRE);
+        uint32_t tail = g_tail;
+        if (head < tail && tail == g_end) tail = 0;
+        uint32_t stop = head >= tail ? head : g_end;
+        if (stop == tail) {
+            __atomic_store_n(&g_tail, tail, __ATOMIC_RELEASE);
+            return;
+        }
+
+        ssize_t k = send(g_client, g_ring + tail, stop - tail, SEND_FLAGS);
+        if (k < 0 && (errno == EAGAIN || errno == EWOULDBLOCK)) {
+            __atomic_store_n(&g_tail, tail, __ATOMIC_RELEASE);
+            return;
+        }
+        if (k <= 0) {
+            close_client();
+            return;
+        }
+        g_stats.sent_bytes += (uint64_t)k;
+        __atomic_store_n(&g_tail, tail + (uint32_t)k, __ATOMIC_RELEASE);
+    }
+}
+
+// ═══════════════════════════════════════════════════════════════
+//  START / STOP
+// ═══════════════════════════════════════════════════════════════
+#ifdef ESP_PLATFORM
+static TaskHandle_t g_task;
+
+static void sender_task(void *arg)
+{
+    (void)arg;
+    for (;;) {
+        remote_view_poll();
+        vTaskDelay(pdMS_TO_TICKS(SENDER_PERIOD_MS));
+    }
+}
+
+static uint8_t *ring_alloc(void)
+{
+    return heap_caps_malloc(REMOTE_RING_SIZE, MALLOC_CAP_SPIRAM);
+}
+#else
+static uint8_t *ring_alloc(void)
+{
+    return malloc(REMOTE_RING_SIZE);
+}
+#endif
+
+bool remote_view_start(uint16_t port, uint16_t width, uint16_t height)
+{
+    if (g_listen >= 0) return true;
+    if (!g_ring && !(g_ring = ring_alloc())) return false;
+
+    g_width = width;
+    g_height = height;
+    g_head = g_tail = g_end = 0;
+    memset(&g_stats, 0, sizeof(g_stats));
+
+    int fd = socket(AF_INET, SOCK_STREAM, 0);
+    if (fd < 0) return false;
+    int one = 1;
+    setsockopt(fd, SOL_SOCKET, SO_REUSEADDR, &one, sizeof(one));
+
+    struct sockaddr_in addr = {
+        .sin_family      = AF_INET,
+        .sin_port        = htons(port),
+        .sin_addr.s_addr = htonl(INADDR_ANY),
+    };
+    socklen_t alen = sizeof(addr);
+    if (bind(fd, (struct sockaddr *)&addr, sizeof(addr)) < 0 || listen(fd, 1) < 0 ||
+        getsockname(fd, (struct sockaddr *)&addr, &alen) < 0) {
+        close(fd);
+        return false;
+    }
+    fcntl(fd, F_SETFL, fcntl(fd, F_GETFL, 0) | O_NONBLOCK);
+    g_listen = fd;
+    g_port = ntohs(addr.sin_port);
+
+#ifdef ESP_PLATFORM
+    if (!g_task && xTaskCreate(sender_task, "remote_view", 4096, NULL, 3, &g_task) != pdPASS) {
+        remote_view_stop();
+        return false;
+    }
+#endif
+    return true;
+}
+
+void remote_view_stop(void)
+{
+#ifdef ESP_PLATFORM
+    if (g_task) {
+        vTaskDelete(g_task);
+        g_task = NULL;
+    }
+#endif
+    close_client();
+    if (g_listen >= 0) close(g_listen);
+    g_listen = -1;
+}
+
+uint16_t remote_view_port(void)
+{
+    return g_port;
+}
+
+void remote_view_get_stats(remote_stats_t *out)
+{
+    *out = g_stats;
+    out->connected = g_connected;
+}
@@ -0,0 +1,69 @@
+#pragma once
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+/* ============================================================
+ * Autoclave Control System - remote live view
+ * Taps the display flush: each rendered area is RLE-compressed
+ * straight from the draw buffer into a send ring and streamed to
+ * one TCP viewer (tools/remote_viewer.c). Only dirty areas are
+ * sent, so bandwidth follows what changes on screen.
+ *
+ * In the display flush callback, before the panel transfer:
+ *   remote_view_on_flush(area->x1, area->y1, area->x2, area->y2,
+ *                        (const uint16_t *)px_map,
+ *                        lv_display_flush_is_last(disp));
+ *
+ * When a viewer connects, or the ring overflows, a full redraw
+ * is requested; the UI timer picks it up with
+ * remote_view_take_resync() and invalidates the screen.
+ *
+ * ESP-IDF: lwIP sockets, a sender task drains the ring.
+ * Host: POSIX sockets, call remote_view_poll() periodically.
+ * ============================================================ */
+
+// ─── Wire format (little-endian) ─────────────────────────────
+// Hello, once per connection:
+//   u32 magic 'AKRV', u16 width, u16 height, u8 version, u8 format, u16 0
+// Then one header + payload per flushed area:
+//   u16 x1, y1, x2, y2 (inclusive), u8 codec, u8 flags, u16 0, u32 len
+// REMOTE_CODEC_RLE payload is a token stream over 16-bit pixels:
+//   0x80|n  pixel        n+1 copies of pixel (2..128)
+//   n       pixels…      n+1 literal pixels  (1..128)
+#define REMOTE_MAGIC         0x56524B41u     // "AKRV"
+#define REMOTE_VERSION       1
+#define REMOTE_FORMAT_RGB565 1
+#define REMOTE_CODEC_RAW     0
+#define REMOTE_CODEC_RLE     1
+#define REMOTE_FLAG_LAST     0x01           // Last area of a refresh
+
+#define REMOTE_DEFAULT_PORT  5900
+#define REMOTE_RING_SIZE     (256 * 1024)   // Power of two
+
+typedef struct {
+    uint32_t areas;
+    uint32_t dropped;       // Areas lost to a full ring
+    uint32_t resyncs;
+    uint64_t raw_bytes;     // Pixel bytes tapped
+    uint64_t sent_bytes;    // Bytes written to the socket
+    bool     connected;
+} remote_stats_t;
+
+// port 0 picks a free port, see remote_view_port()
+bool     remote_view_start(uint16_t port, uint16_t width, uint16_t height);
+void     remote_view_stop(void);
+uint16_t remote_view_port(void);
+
+void     remote_view_on_flush(int x1, int y1, int x2, int y2,
+                              const uint16_t *px, bool last);
+bool     remote_view_take_resync(void);
+void     remote_view_poll(void);
+void     remote_view_get_stats(remote_stats_t *out);
+
+// Codec, shared with the viewer. Returns bytes written, 0 if the
+// output would exceed cap.
+size_t   remote_rle_encode(const uint16_t *px, size_t n, uint8_t *out, size_t cap);
+// Returns pixels written, 0 on a malformed stream
+size_t   remote_rle_decode(const uint8_t *in, size_t len, uint16_t *px, size_t n);
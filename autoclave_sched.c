@@ -0,0 +1,254 @@
+/*
+ * ============================================================
+ *  Autoklav — cykelkö
+ *
+ *  En enkel tillståndsmaskin per kammare. Hålltiden måste
+ *  ligga i bandet utan avbrott; en dipp nollställer den. Utan
+ *  aktuell mätning (NAN) står allt still och ingen hålltid
+ *  räknas.
+ *  Uppskattningarna använder den identifierade modellen när
+ *  den finns, annars fasta schablonvärden.
+ * ============================================================
+ */
+
+#include "autoclave_sched.h"
+#include <math.h>
+#include <string.h>
+
+#define BIAS_GAIN       0.5f        // Weight of the newest phase in the corrections
+
+static uint32_t heat_s(const sched_t *s, float from_c, float to_c);
+
+void sched_init(sched_t *s, const sched_cfg_t *cfg)
+{
+    memset(s, 0, sizeof(*s));
+    s->cfg = *cfg;
+    if (s->cfg.standby_c > s->cfg.door_safe_c) s->cfg.standby_c = s->cfg.door_safe_c;
+    s->phase = SCHED_IDLE;
+}
+
+// A heat-up that started far from equilibrium can identify nonsense
+void sched_set_model(sched_t *s, const fopdt_model_t *m)
+{
+    if (m && m->valid && m->K > 0 && m->tau_s > 0 && m->tau_s < SCHED_MODEL_MAX_TAU_S)
+        s->model = *m;
+}
+
+bool sched_enqueue(sched_t *s, const sched_job_t *job)
+{
+    if (s->count >= SCHED_MAX_JOBS) return false;
+    s->job[s->count++] = *job;
+    return true;
+}
+
+static bool running(const sched_t *s)
+{
+    return s->phase == SCHED_HEAT || s->phase == SCHED_HOLD || s->phase == SCHED_POST;
+}
+
+static void drop(sched_t *s, int idx)
+{
+    memmove(&s->job[idx], &s->job[idx + 1], (size_t)(s->count - idx - 1) * sizeof(s->job[0]));
+    s->count--;
+}
+
+bool sched_remove(sched_t *s, int idx)
+{
+    if (idx < 0 || idx >= s->count || (idx == 0 && running(s))) return false;
+    drop(s, idx);
+    return true;
+}
+
+void sched_load_ready(sched_t *s)
+{
+    if (!running(s)) s->ready = true;
+}
+
+void sched_abort(sched_t *s)
+{
+    s->count = 0;
+    s->ready = false;
+    s->phase = SCHED_IDLE;
+}
+
+static float phase_setpoint(const sched_t *s)
+{
+    switch (s->phase) {
+    case SCHED_LOAD:
+        return s->count && s->cfg.standby_c > 0 ? s->cfg.standby_c : -1.0f;
+    case SCHED_HEAT:
+    case SCHED_HOLD:
+        return s->job[0].setpoint_c;
+    default:
+        return -1.0f;
+    }
+}
+
+static void enter(sched_t *s, sched_phase_t p, uint32_t now_s, sched_out_t *out)
+{
+    s->phase = p;
+    s->phase_s = now_s;
+    out->changed = true;
+}
+
+sched_out_t sched_step(sched_t *s, uint32_t now_s, float temp_c)
+{
+    sched_out_t out = { 0 };
+    uint32_t dt = now_s > s->last_s ? now_s - s->last_s : 0;
+    s->last_s = now_s;
+    const sched_job_t *j = &s->job[0];
+
+    if (isnan(temp_c)) {
+        out.phase = s->phase;
+        out.setpoint_c = phase_setpoint(s);
+        return out;
+    }
+
+    switch (s->phase) {
+    case SCHED_IDLE:
+        if (s->count) enter(s, SCHED_LOAD, now_s, &out);
+        break;
+    case SCHED_LOAD:
+        if (!s->count) {
+            enter(s, SCHED_IDLE, now_s, &out);
+        } else if (s->ready) {
+            s->ready = false;
+            s->in_band_s = 0;
+            enter(s, SCHED_HEAT, now_s, &out);
+            s->run_s = now_s;
+            s->heat_est_s = heat_s(s, temp_c, j->setpoint_c);
+            out.cycle_started = true;
+            out.program = j->program;
+        }
+        break;
+    case SCHED_HEAT:
+        if (temp_c >= j->setpoint_c - SCHED_HOLD_BAND_C) {
+            enter(s, SCHED_HOLD, now_s, &out);
+            s->hold_at_s = now_s;
+            s->heat_bias_s += BIAS_GAIN * ((float)(now_s - s->run_s) - (float)s->heat_est_s
+                                           - s->heat_bias_s);
+        }
+        break;
+    case SCHED_HOLD:
+        if (temp_c < j->setpoint_c - SCHED_HOLD_BAND_C) {
+            out.hold_restarted = s->in_band_s > 0;
+            s->in_band_s = 0;
+            break;
+        }
+        s->in_band_s += dt;
+        if (s->in_band_s >= j->hold_s) {
+            s->hold_extra_s += BIAS_GAIN * ((float)(now_s - s->hold_at_s - j->hold_s)
+                                            - s->hold_extra_s);
+            enter(s, SCHED_POST, now_s, &out);
+        }
+        break;
+    case SCHED_POST:
+        if (now_s - s->phase_s >= j->post_s && temp_c <= s->cfg.door_safe_c) {
+            out.cycle_done = true;
+            out.program = j->program;
+            drop(s, 0);
+            s->ready = false;               // Door must open for the next load
+            enter(s, s->count ? SCHED_LOAD : SCHED_IDLE, now_s, &out);
+        }
+        break;
+    }
+    out.phase = s->phase;
+    out.setpoint_c = phase_setpoint(s);
+    return out;
+}
+
+// ═══════════════════════════════════════════════════════════════
+//  ESTIMATES
+// ═══════════════════════════════════════════════════════════════
+static float tau_s(const sched_t *s)
+{
+    return s->model.valid ? s->model.tau_s : SCHED_FALLBACK_TAU_S;
+}
+
+static uint32_t heat_s(const sched_t *s, float from_c, float to_c)
+{
+    float t = ctrl_model_heat_time(&s->model, from_c, to_c);
+    if (t < 0) t = from_c < to_c ? (to_c - from_c) * 60.0f / SCHED_FALLBACK_HEAT_C_MIN : 0;
+    return (uint32_t)(t + 0.5f);
+}
+
+// Heat-up as finished heat-ups have actually been running
+static uint32_t heat_run_s(const sched_t *s, float from_c, float to_c)
+{
+    float t = (float)heat_s(s, from_c, to_c) + s->heat_bias_s;
+    return t > 0 ? (uint32_t)(t + 0.5f) : 0;
+}
+
+static uint32_t hold_run_s(const sched_t *s, const sched_job_t *j)
+{
+    return j->hold_s + (s->hold_extra_s > 0 ? (uint32_t)(s->hold_extra_s + 0.5f) : 0);
+}
+
+// Heater off, from 'from_c' down to 'to_c'
+static uint32_t cool_s(const sched_t *s, float from_c, float to_c)
+{
+    float amb = s->cfg.ambient_c;
+    if (from_c <= to_c || to_c <= amb) return 0;
+    return (uint32_t)(tau_s(s) * logf((from_c - amb) / (to_c - amb)) + 0.5f);
+}
+
+static float cooled(const sched_t *s, float from_c, uint32_t t)
+{
+    float amb = s->cfg.ambient_c;
+    return amb + (from_c - amb) * expf(-(float)t / tau_s(s));
+}
+
+static uint32_t post_s(const sched_t *s, const sched_job_t *j, float from_c, uint32_t done_s)
+{
+    uint32_t c = cool_s(s, from_c, s->cfg.door_safe_c);
+    uint32_t d = j->post_s > done_s ? j->post_s - done_s : 0;
+    return c > d ? c : d;
+}
+
+int sched_plan(const sched_t *s, uint32_t now_s, float temp_c, sched_slot_t *out, int max)
+{
+    uint32_t t = now_s;
+    float    temp = temp_c;
+    int n = 0;
+    for (int i = 0; i < s->count && n < max; i++, n++) {
+        const sched_job_t *j = &s->job[i];
+        sched_slot_t *o = &out[n];
+        o->program = j->program;
+
+        if (i == 0 && running(s)) {
+            o->start_s = s->run_s;
+            if (s->phase == SCHED_HEAT) {
+                o->hold_s = now_s + heat_run_s(s, temp_c, j->setpoint_c);
+                o->end_s  = o->hold_s + hold_run_s(s, j) + post_s(s, j, j->setpoint_c, 0);
+            } else if (s->phase == SCHED_HOLD) {
+                uint32_t spent = now_s - s->hold_at_s, total = hold_run_s(s, j);
+                o->hold_s = s->hold_at_s;
+                o->end_s  = now_s + (total > spent ? total - spent : j->hold_s - s->in_band_s) +
+                            post_s(s, j, j->setpoint_c, 0);
+            } else {
+                o->hold_s = s->hold_at_s;
+                o->end_s  = now_s + post_s(s, j, temp_c, now_s - s->phase_s);
+            }
+            t = o->end_s;
+            temp = s->cfg.door_safe_c < temp_c ? s->cfg.door_safe_c : temp_c;
+            continue;
+        }
+
+        // Loading: a load already in progress started at phase entry
+        uint32_t load_from = i == 0 && s->phase == SCHED_LOAD ? s->phase_s : t;
+        uint32_t start = load_from + s->cfg.reload_s;
+        if (start < t) start = t;
+        if (i == 0 && s->ready) start = now_s;
+
+        float from;
+        if (s->cfg.standby_c > 0) from = temp > s->cfg.standby_c ? temp : s->cfg.standby_c;
+        else                      from = cooled(s, temp, start - t);
+
+        o->start_s = start;
+        o->hold_s  = start + heat_run_s(s, from, j->setpoint_c);
+        o->end_s   = o->hold_s + hold_run_s(s, j) + post_s(s, j, j->setpoint_c, 0);
+        t = o->end_s;
+        temp = s->cfg.door_safe_c;
+    }
+    return n;
+}
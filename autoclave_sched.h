@@ -0,0 +1,114 @@
+#pragma once
+
+#include "autoclave_ctrl.h"
+
+/* ============================================================
+ * Autoclave Control System - cycle queue
+ * Operators queue programs per chamber; the queue runs them
+ * back to back:
+ *
+ *   LOAD ──ready──▶ HEAT ──▶ HOLD ──▶ POST ──▶ LOAD (next) / IDLE
+ *
+ * HEAT runs to the program setpoint, HOLD counts hold_s inside
+ * the band, POST has the heater off until drying time has passed
+ * and the chamber is below door_safe_c. hold_s must be spent in
+ * the band without a break: a dip below it starts the count
+ * again (reported as hold_restarted). While the next load is
+ * being put in, the chamber is kept at standby_c instead of
+ * cooling down. standby_c is capped at door_safe_c, the
+ * temperature the door may be opened at. With nothing queued
+ * the heater is off.
+ *
+ * Estimates come from the identified model (or fallback rates)
+ * and are corrected by how far finished heat-ups and holds
+ * ran over them.
+ *
+ * The queue only decides setpoints; the control task applies
+ * them (ctrl_start / ctrl_stop). sched_step() runs once per
+ * second with the latest measured temperature, or NAN when there
+ * is no current reading: the clock then moves on but nothing is
+ * decided and no hold time is credited.
+ * ============================================================ */
+
+#define SCHED_MAX_JOBS       8
+#define SCHED_HOLD_BAND_C    0.5f
+#define SCHED_FALLBACK_HEAT_C_MIN  5.0f     // Estimates without a model
+#define SCHED_FALLBACK_TAU_S       900.0f
+#define SCHED_MODEL_MAX_TAU_S      7200.0f  // Identified models beyond this are ignored
+
+typedef enum {
+    SCHED_IDLE,             // Queue empty, heater off
+    SCHED_LOAD,             // Waiting for the operator; standby heat
+    SCHED_HEAT,
+    SCHED_HOLD,
+    SCHED_POST,             // Cooling / drying, heater off
+} sched_phase_t;
+
+typedef struct {
+    uint8_t  program;
+    float    setpoint_c;
+    uint32_t hold_s;
+    uint32_t post_s;        // Minimum drying / venting time
+} sched_job_t;
+
+typedef struct {
+    float    standby_c;     // 0 = no pre-heat between cycles
+    float    door_safe_c;
+    float    ambient_c;
+    uint32_t reload_s;      // Expected unload + load time, for estimates
+} sched_cfg_t;
+
+#define SCHED_CFG_DEFAULT { \
+    .standby_c = 80.0f, .door_safe_c = 80.0f, .ambient_c = 20.0f, .reload_s = 300 }
+
+// What the control task should do; setpoint_c < 0 = heater off
+typedef struct {
+    sched_phase_t phase;
+    float    setpoint_c;
+    bool     changed;       // Phase or setpoint changed this step
+    bool     cycle_started; // job[0] entered HEAT
+    bool     cycle_done;    // job[0] finished POST and was removed
+    bool     hold_restarted; // Dip below the band, hold counts from zero
+    uint8_t  program;       // Of the job that started / finished
+} sched_out_t;
+
+// Estimated timeline entry, seconds on the sched_step() clock
+typedef struct {
+    uint8_t  program;
+    uint32_t start_s;       // Heat-up begins
+    uint32_t hold_s;        // Hold begins
+    uint32_t end_s;         // Door can be opened
+} sched_slot_t;
+
+typedef struct {
+    sched_cfg_t   cfg;
+    sched_job_t   job[SCHED_MAX_JOBS];     // job[0] is current / next
+    int           count;
+    sched_phase_t phase;
+    uint32_t      phase_s;                  // Clock at phase entry
+    uint32_t      run_s;                    // Heat-up of job[0] began
+    uint32_t      hold_at_s;                // Hold of job[0] began
+    uint32_t      in_band_s;                // Hold time counted so far
+    uint32_t      last_s;
+    bool          ready;                    // Load confirmed
+    fopdt_model_t model;
+
+    // Learned from finished phases, added to the estimates
+    uint32_t      heat_est_s;               // Estimate made at heat-up start
+    float         heat_bias_s;              // Actual - estimated heat-up
+    float         hold_extra_s;             // Lost to restarts and missing readings
+} sched_t;
+
+void sched_init(sched_t *s, const sched_cfg_t *cfg);
+void sched_set_model(sched_t *s, const fopdt_model_t *m);
+
+bool sched_enqueue(sched_t *s, const sched_job_t *job);
+bool sched_remove(sched_t *s, int idx);         // Queued jobs only, not a running one
+void sched_load_ready(sched_t *s);              // Next load is in, door closed
+void sched_abort(sched_t *s);                   // Drop the running job and the queue
+
+sched_out_t sched_step(sched_t *s, uint32_t now_s, float temp_c);
+
+// Estimated start/hold/end of every queued job from 'now_s'
+int  sched_plan(const sched_t *s, uint32_t now_s, float temp_c,
+                sched_slot_t *out, int max);
@@ -0,0 +1,197 @@
+/*
+ * ============================================================
+ *  Autoklav — simulerad kammare
+ *
+ *  Används för att köra reglering och schemaläggning på Linux
+ *  utan hårdvara. Modellen är medvetet enkel (en tidskonstant
+ *  plus dödtid); den riktiga kammaren har fler poler, så
+ *  jämförelser här är relativa, inte absoluta.
+ * ============================================================
+ */
+
+#include "autoclave_sim.h"
+#include "autoclave_ctrl.h"
+#include <math.h>
+#include <stdio.h>
+#include <string.h>
+
+#define SIM_DT_S            1.0f
+#define SIM_RUN_S           5400.0f
+#define SIM_BAND_C          0.5f
+
+const sim_plant_cfg_t SIM_PLANT_DEFAULT = {
+    .K         = 160.0f,
+    .tau_s     = 600.0f,
+    .dead_s    = 40.0f,
+    .ambient_c = 20.0f,
+    .noise_c   = 0.05f,
+};
+
+static float noise(sim_plant_t *p)
+{
+    // xorshift32, uniform in [-1, 1)
+    uint32_t x = p->rng;
+    x ^= x << 13; x ^= x >> 17; x ^= x << 5;
+    p->rng = x;
+    return (float)(x >> 8) / (float)(1u << 23) - 1.0f;
+}
+
+void sim_plant_init(sim_plant_t *p, const sim_plant_cfg_t *cfg, float dt_s)
+{
+    memset(p, 0, sizeof(*p));
+    p->cfg  = *cfg;
+    p->dt_s = dt_s;
+    p->rng  = 0x2545F491u;
+    p->delay_len = (uint32_t)(cfg->dead_s / dt_s + 0.5f);
+    if (p->delay_len >= SIM_MAX_DELAY) p->delay_len = SIM_MAX_DELAY - 1;
+    sim_plant_set_temp(p, cfg->ambient_c);
+}
+
+void sim_plant_set_temp(sim_plant_t *p, float temp_c)
+{
+    p->x = temp_c;
+    for (uint32_t i = 0; i <= p->delay_len; i++) p->delay[i] = temp_c;
+}
+
+float sim_plant_step(sim_plant_t *p, float duty)
+{
+    if (duty < 0) duty = 0;
+    if (duty > 1) duty = 1;
+    const sim_plant_cfg_t *c = &p->cfg;
+    p->x += (c->ambient_c + c->K * duty - p->x) * p->dt_s / c->tau_s;
+
+    // The ring holds the last delay_len + 1 states; read the oldest
+    p->delay[p->delay_pos] = p->x;
+    p->delay_pos = (p->delay_pos + 1) % (p->delay_len + 1);
+    float measured = p->delay[p->delay_pos];
+    return measured + c->noise_c * noise(p);
+}
+
+void sim_heatup_run(const sim_plant_cfg_t *cfg, float setpoint_c,
+                    bool model_based, float kp, float ki, float kd,
+                    sim_heatup_t *out)
+{
+    sim_plant_t plant;
+    ctrl_t ctrl;
+    sim_plant_init(&plant, cfg, SIM_DT_S);
+    ctrl_init(&ctrl, SIM_DT_S, model_based);
+    ctrl_set_gains(&ctrl, kp, ki, kd);
+
+    float temp = cfg->ambient_c;
+    ctrl_start(&ctrl, setpoint_c, temp);
+
+    out->time_to_sp_s = -1;
+    out->settle_s     = -1;
+    out->overshoot_c  = 0;
+    for (float t = 0; t < SIM_RUN_S; t += SIM_DT_S) {
+        temp = sim_plant_step(&plant, ctrl_step(&ctrl, temp));
+        bool in_band = temp > setpoint_c - SIM_BAND_C && temp < setpoint_c + SIM_BAND_C;
+        if (in_band && out->time_to_sp_s < 0) out->time_to_sp_s = t;
+        if (!in_band && out->time_to_sp_s >= 0) out->settle_s = t;
+        if (temp - setpoint_c > out->overshoot_c) out->overshoot_c = temp - setpoint_c;
+    }
+    if (out->time_to_sp_s >= 0 && out->settle_s < out->time_to_sp_s)
+        out->settle_s = out->time_to_sp_s;
+}
+
+size_t sim_compare_heatup(const sim_plant_cfg_t *cfg, const float *setpoints,
+                          int n, char *buf, size_t len)
+{
+    static const char *names[2] = { "PID", "Modell+PID" };
+    if (len == 0) return 0;
+    int w = snprintf(buf, len, "%-9s %-11s %10s %10s %10s\n",
+                     "Börvärde", "Regulator", "Nå [s]", "Stabil [s]", "Över [°C]");
+    size_t used = w < 0 ? 0 : (size_t)w;
+
+    for (int i = 0; i < n && used < len; i++) {
+        for (int mb = 0; mb < 2 && used < len; mb++) {
+            sim_heatup_t r;
+            sim_heatup_run(cfg, setpoints[i], mb, 2.5f, 0.8f, 0.3f, &r);
+            w = snprintf(buf + used, len - used, "%6.0f°C %-11s %10.0f %10.0f %10.2f\n",
+                         setpoints[i], names[mb], r.time_to_sp_s, r.settle_s, r.overshoot_c);
+            if (w > 0) used += (size_t)w;
+        }
+    }
+    return used < len ? used : len - 1;
+}
+
+// ═══════════════════════════════════════════════════════════════
+//  SHIFT
+// ═══════════════════════════════════════════════════════════════
+void sim_shift_run(const sim_plant_cfg_t *cfg, const sched_job_t *jobs, int n,
+                   float shift_s, uint32_t reload_s, bool preheat, sim_shift_t *out)
+{
+    sim_plant_t plant;
+    ctrl_t ctrl;
+    sched_t sched;
+    sched_cfg_t sc = SCHED_CFG_DEFAULT;
+    sc.ambient_c = cfg->ambient_c;
+    sc.reload_s  = reload_s;
+    if (!preheat) sc.standby_c = 0;
+
+    sim_plant_init(&plant, cfg, SIM_DT_S);
+    ctrl_init(&ctrl, SIM_DT_S, true);
+    ctrl_set_gains(&ctrl, 2.5f, 0.8f, 0.3f);
+    sched_init(&sched, &sc);
+    memset(out, 0, sizeof(*out));
+
+    float temp = cfg->ambient_c, duty = 0, cycle_sum = 0, heat_sum = 0, err_sum = 0;
+    uint32_t next = 0, est_end = 0, hold_at = 0;
+    bool heating = false;
+    for (uint32_t t = 0; t < (uint32_t)shift_s; t++) {
+        // Keep two jobs queued; the operator loads reload_s after LOAD begins
+        while (sched.count < 2) sched_enqueue(&sched, &jobs[next++ % n]);
+        if (sched.phase == SCHED_LOAD && t - sched.phase_s >= reload_s) sched_load_ready(&sched);
+
+        sched_out_t o = sched_step(&sched, t, temp);
+        if (o.cycle_started) {
+            sched_slot_t slot;
+            sched_plan(&sched, t, temp, &slot, 1);
+            est_end = slot.end_s;
+            heating = true;
+        }
+        if (heating && o.phase == SCHED_HOLD) {
+            hold_at = t;
+            heating = false;
+            sched_set_model(&sched, &ctrl.model);
+        }
+        if (o.cycle_done) {
+            out->loads++;
+            cycle_sum += (float)(t - sched.run_s);
+            heat_sum  += (float)(hold_at - sched.run_s);
+            err_sum   += fabsf((float)t - (float)est_end);
+        }
+        if (o.changed) {
+            if (o.setpoint_c < 0) ctrl_stop(&ctrl);
+            else                  ctrl_start(&ctrl, o.setpoint_c, temp);
+        }
+        duty = o.setpoint_c < 0 ? 0 : ctrl_step(&ctrl, temp);
+        out->heater_h += duty * SIM_DT_S / 3600.0f;
+        temp = sim_plant_step(&plant, duty);
+    }
+    if (out->loads) {
+        out->mean_cycle_s   = cycle_sum / out->loads;
+        out->mean_heat_s    = heat_sum / out->loads;
+        out->mean_est_err_s = err_sum / out->loads;
+    }
+}
+
+size_t sim_compare_shift(const sim_plant_cfg_t *cfg, const sched_job_t *jobs, int n,
+                         float shift_s, uint32_t reload_s, char *buf, size_t len)
+{
+    static const char *names[2] = { "Kö", "Kö+förvärm" };
+    if (len == 0) return 0;
+    int w = snprintf(buf, len, "%-11s %6s %10s %10s %10s %10s\n",
+                     "Läge", "Laster", "Cykel [s]", "Värm [s]", "Värme [h]", "Fel [s]");
+    size_t used = w < 0 ? 0 : (size_t)w;
+
+    for (int pre = 0; pre < 2 && used < len; pre++) {
+        sim_shift_t r;
+        sim_shift_run(cfg, jobs, n, shift_s, reload_s, pre, &r);
+        w = snprintf(buf + used, len - used, "%-11s %6u %10.0f %10.0f %10.2f %10.0f\n",
+                     names[pre], (unsigned)r.loads, r.mean_cycle_s, r.mean_heat_s,
+                     r.heater_h, r.mean_est_err_s);
+        if (w > 0) used += (size_t)w;
+    }
+    return used < len ? used : len - 1;
+}
@@ -0,0 +1,75 @@
+#pragma once
+
+#include "autoclave_sched.h"
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+/* ============================================================
+ * Autoclave Control System - simulated chamber (host builds)
+ * First-order-plus-dead-time thermal plant driven by SSR duty,
+ * plus a heat-up comparison of plain PID vs the model-based
+ * controller, and a shift of queued cycles with and without
+ * standby pre-heat.
+ * ============================================================ */
+
+#define SIM_MAX_DELAY        512     // Dead-time samples
+
+typedef struct {
+    float K;                // °C rise at 100 % duty
+    float tau_s;
+    float dead_s;
+    float ambient_c;
+    float noise_c;          // Peak uniform measurement noise
+} sim_plant_cfg_t;
+
+typedef struct {
+    sim_plant_cfg_t cfg;
+    float    dt_s;
+    float    x;             // Chamber temperature before the dead time
+    float    delay[SIM_MAX_DELAY];
+    uint32_t delay_len;
+    uint32_t delay_pos;
+    uint32_t rng;
+} sim_plant_t;
+
+// Default plant: 20 °C ambient, 180 °C at full power, 10 min time
+// constant, 40 s dead time (loaded 150 L chamber, jacketed)
+extern const sim_plant_cfg_t SIM_PLANT_DEFAULT;
+
+void  sim_plant_init(sim_plant_t *p, const sim_plant_cfg_t *cfg, float dt_s);
+void  sim_plant_set_temp(sim_plant_t *p, float temp_c);
+float sim_plant_step(sim_plant_t *p, float duty);     // Measured °C
+
+typedef struct {
+    float time_to_sp_s;     // First entry into the ±0.5 °C band, < 0 if never
+    float settle_s;         // Last exit from the band
+    float overshoot_c;      // Peak above setpoint
+} sim_heatup_t;
+
+void   sim_heatup_run(const sim_plant_cfg_t *cfg, float setpoint_c,
+                      bool model_based, float kp, float ki, float kd,
+                      sim_heatup_t *out);
+
+// Text report for the given setpoints, one line per controller,
+// both using the default PID slider gains
+size_t sim_compare_heatup(const sim_plant_cfg_t *cfg, const float *setpoints,
+                          int n, char *buf, size_t len);
+
+// ─── Shift of queued cycles ──────────────────────────────────
+// The jobs are queued round-robin; the simulated operator
+// confirms each load reload_s after the door could be opened.
+typedef struct {
+    uint32_t loads;             // Cycles finished within the shift
+    float    mean_cycle_s;      // Heat-up start to door open
+    float    mean_heat_s;
+    float    heater_h;          // Full-power equivalent hours
+    float    mean_est_err_s;    // |estimated - actual| end, at cycle start
+} sim_shift_t;
+
+void   sim_shift_run(const sim_plant_cfg_t *cfg, const sched_job_t *jobs, int n,
+                     float shift_s, uint32_t reload_s, bool preheat, sim_shift_t *out);
+
+// Text report: the same shift without and with pre-heat
+size_t sim_compare_shift(const sim_plant_cfg_t *cfg, const sched_job_t *jobs, int n,
+                         float shift_s, uint32_t reload_s, char *buf, size_t len);
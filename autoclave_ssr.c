@@ -0,0 +1,243 @@
+/*
+ * ============================================================
+ *  Autoklav — SSR-styrning (tidsproportionerande)
+ *
+ *  Varje fönster börjar med en till-puls och slutar med en
+ *  från-puls. Pulslängden räknas om en gång per fönster; i
+ *  övriga slots är ISR:en en jämförelse och ev. GPIO-skrivning.
+ * ============================================================
+ */
+
+#include "autoclave_ssr.h"
+#include <string.h>
+
+#ifdef ESP_PLATFORM
+#include "driver/gpio.h"
+#include "driver/gptimer.h"
+#include "esp_attr.h"
+#define SSR_ISR_ATTR IRAM_ATTR
+#else
+#define SSR_ISR_ATTR
+#endif
+
+#define SLOT_US_TIMER   1000u
+#define APPLIED_SHIFT   3           // EMA over ~8 windows
+
+static ssr_cfg_t g_cfg;
+static bool      g_ready;
+
+// Written by the control task, read by the ISR
+static volatile uint16_t g_duty_pm;         // Requested duty, ‰
+static volatile bool     g_enabled;
+
+// ISR state
+static uint32_t g_window;                   // Slots per window
+static uint32_t g_min_on, g_min_off;        // Slots
+static uint32_t g_pos;
+static uint32_t g_on_slots;
+static uint32_t g_on_count;
+static int32_t  g_carry;                    // ‰·slots not yet applied
+static bool     g_level;
+static volatile uint32_t g_applied_avg;     // ‰ << APPLIED_SHIFT, EMA
+static ssr_stats_t g_stats;
+
+// ═══════════════════════════════════════════════════════════════
+//  BACKENDS
+// ═══════════════════════════════════════════════════════════════
+#ifdef ESP_PLATFORM
+static gptimer_handle_t g_timer;
+
+static bool IRAM_ATTR timer_alarm_cb(gptimer_handle_t t,
+                                     const gptimer_alarm_event_data_t *ev, void *ctx)
+{
+    (void)t; (void)ev; (void)ctx;
+    ssr_slot_isr();
+    return false;
+}
+
+static void IRAM_ATTR zero_cross_isr(void *arg)
+{
+    (void)arg;
+    ssr_slot_isr();
+}
+
+// Needs CONFIG_GPIO_CTRL_FUNC_IN_IRAM for use from the ISR
+static inline void SSR_ISR_ATTR backend_write(bool on)
+{
+    gpio_set_level(g_cfg.gpio_out, on);
+}
+
+static bool backend_start(void)
+{
+    gpio_config_t out = {
+        .pin_bit_mask = 1ULL << g_cfg.gpio_out,
+        .mode         = GPIO_MODE_OUTPUT,
+    };
+    if (gpio_config(&out) != ESP_OK) return false;
+    gpio_set_level(g_cfg.gpio_out, 0);
+
+    if (g_cfg.zero_cross) {
+        gpio_config_t zc = {
+            .pin_bit_mask = 1ULL << g_cfg.gpio_zc,
+            .mode         = GPIO_MODE_INPUT,
+            .intr_type    = GPIO_INTR_POSEDGE,
+        };
+        if (gpio_config(&zc) != ESP_OK) return false;
+        esp_err_t err = gpio_install_isr_service(ESP_INTR_FLAG_IRAM);
+        if (err != ESP_OK && err != ESP_ERR_INVALID_STATE) return false;
+        return gpio_isr_handler_add(g_cfg.gpio_zc, zero_cross_isr, NULL) == ESP_OK;
+    }
+
+    gptimer_config_t tc = {
+        .clk_src       = GPTIMER_CLK_SRC_DEFAULT,
+        .direction     = GPTIMER_COUNT_UP,
+        .resolution_hz = 1000000,
+    };
+    if (gptimer_new_timer(&tc, &g_timer) != ESP_OK) return false;
+    gptimer_event_callbacks_t cbs = { .on_alarm = timer_alarm_cb };
+    gptimer_alarm_config_t alarm = {
+        .alarm_count  = SLOT_US_TIMER,
+        .reload_count = 0,
+        .flags.auto_reload_on_alarm = true,
+    };
+    // Without the alarm the output would never toggle: every step counts
+    esp_err_t err = gptimer_register_event_callbacks(g_timer, &cbs, NULL);
+    if (err == ESP_OK) err = gptimer_set_alarm_action(g_timer, &alarm);
+    if (err == ESP_OK) err = gptimer_enable(g_timer);
+    if (err == ESP_OK) {
+        err = gptimer_start(g_timer);
+        if (err != ESP_OK) gptimer_disable(g_timer);
+    }
+    if (err != ESP_OK) {
+        gptimer_del_timer(g_timer);
+        g_timer = NULL;
+        return false;
+    }
+    return true;
+}
+
+#else
+static inline void backend_write(bool on) { (void)on; }
+static bool backend_start(void) { return true; }
+
+void ssr_sim_run(uint32_t slots)
+{
+    while (slots--) ssr_slot_isr();
+}
+#endif
+
+// ═══════════════════════════════════════════════════════════════
+//  SCHEDULER
+// ═══════════════════════════════════════════════════════════════
+static uint32_t ms_to_slots(uint32_t ms, uint32_t slot_us)
+{
+    return (ms * 1000u + slot_us - 1) / slot_us;   // Round up
+}
+
+static void SSR_ISR_ATTR window_start(void)
+{
+    uint32_t pm = g_on_count * 1000u / g_window;
+    g_applied_avg += pm - (g_applied_avg >> APPLIED_SHIFT);
+    g_on_count = 0;
+    g_stats.windows++;
+
+    if (!g_enabled) {
+        g_on_slots = 0;
+        g_carry = 0;
+        return;
+    }
+
+    int32_t want = (int32_t)g_duty_pm * (int32_t)g_window + g_carry;
+    int32_t on = (want + 500) / 1000;
+    if (on < 0) on = 0;
+    if (on > (int32_t)g_window) on = (int32_t)g_window;
+    if (on > 0 && on < (int32_t)g_min_on) on = 0;
+    else if (on < (int32_t)g_window && (int32_t)g_window - on < (int32_t)g_min_off)
+        on = (int32_t)g_window;
+
+    // Carry what was rounded or clipped away, at most one window
+    g_carry = want - on * 1000;
+    int32_t lim = (int32_t)g_window * 1000;
+    if (g_carry >  lim) g_carry =  lim;
+    if (g_carry < -lim) g_carry = -lim;
+    g_on_slots = (uint32_t)on;
+}
+
+void SSR_ISR_ATTR ssr_slot_isr(void)
+{
+    if (!g_ready) return;
+    if (g_pos == 0) window_start();
+
+    bool out = g_enabled && g_pos < g_on_slots;
+    if (out) g_on_count++;
+    if (out != g_level) {
+        backend_write(out);
+        g_level = out;
+        g_stats.transitions++;
+    }
+    if (++g_pos >= g_window) g_pos = 0;
+}
+
+// ═══════════════════════════════════════════════════════════════
+//  PUBLIC API
+// ═══════════════════════════════════════════════════════════════
+bool ssr_init(const ssr_cfg_t *cfg)
+{
+    g_cfg = *cfg;
+    if (g_cfg.zero_cross && g_cfg.mains_hz == 0) return false;
+
+    uint32_t slot_us = g_cfg.zero_cross ? 500000u / g_cfg.mains_hz : SLOT_US_TIMER;
+    g_window  = ms_to_slots(g_cfg.window_ms, slot_us);
+    g_min_on  = ms_to_slots(g_cfg.min_on_ms, slot_us);
+    g_min_off = ms_to_slots(g_cfg.min_off_ms, slot_us);
+    if (g_window < 2) return false;
+
+    memset(&g_stats, 0, sizeof(g_stats));
+    g_stats.window_slots = g_window;
+    g_stats.slot_us      = slot_us;
+    g_pos = 0; g_on_slots = 0; g_on_count = 0; g_carry = 0;
+    g_level = false;
+    g_applied_avg = 0;
+
+#ifdef ESP_PLATFORM
+    if (g_cfg.gpio_out < 0 || (g_cfg.zero_cross && g_cfg.gpio_zc < 0)) return false;
+#endif
+    g_ready = true;
+    if (!backend_start()) {
+        g_ready = false;
+        return false;
+    }
+    return true;
+}
+
+void ssr_enable(bool on)
+{
+    g_enabled = on;
+}
+
+bool ssr_is_enabled(void)
+{
+    return g_enabled;
+}
+
+void ssr_set_duty(float duty)
+{
+    if (duty < 0) duty = 0;
+    if (duty > 1) duty = 1;
+    g_duty_pm = (uint16_t)(duty * 1000.0f + 0.5f);
+}
+
+float ssr_get_applied_duty(void)
+{
+    return (g_applied_avg >> APPLIED_SHIFT) / 1000.0f;
+}
+
+bool ssr_get_output(void)
+{
+    return g_level;
+}
+
+void ssr_get_stats(ssr_stats_t *out)
+{
+    *out = g_stats;
+}
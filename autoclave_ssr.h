@@ -0,0 +1,52 @@
+#pragma once
+
+#include <stdbool.h>
+#include <stdint.h>
+
+/* ============================================================
+ * Autoclave Control System - SSR time-proportioning output
+ * Turns a controller duty (0..1) into on/off windows. The
+ * scheduler advances one slot per timer tick (1 ms) or, with
+ * zero-cross alignment, per mains half-cycle, so every edge
+ * lands on a slot boundary. Rounding and minimum on/off
+ * clipping are carried into the next window, so the average
+ * applied duty matches the request.
+ * ESP-IDF: gptimer ISR or zero-cross GPIO ISR drives the slots.
+ * Host: no ISR, advance slots with ssr_sim_run().
+ * ============================================================ */
+
+typedef struct {
+    uint32_t window_ms;     // One on/off period
+    uint32_t min_on_ms;     // Shorter pulses are skipped (and carried)
+    uint32_t min_off_ms;
+    bool     zero_cross;    // Slots are mains half-cycles
+    uint32_t mains_hz;
+    int      gpio_out;
+    int      gpio_zc;       // Zero-cross detector input, zero_cross only
+} ssr_cfg_t;
+
+#define SSR_CFG_DEFAULT { \
+    .window_ms = 2000, .min_on_ms = 20, .min_off_ms = 20, \
+    .zero_cross = false, .mains_hz = 50, .gpio_out = -1, .gpio_zc = -1 }
+
+typedef struct {
+    uint32_t windows;
+    uint32_t transitions;
+    uint32_t window_slots;
+    uint32_t slot_us;
+} ssr_stats_t;
+
+bool  ssr_init(const ssr_cfg_t *cfg);
+void  ssr_enable(bool on);
+bool  ssr_is_enabled(void);
+void  ssr_set_duty(float duty);
+float ssr_get_applied_duty(void);     // Measured, averaged over ~8 windows
+bool  ssr_get_output(void);
+void  ssr_get_stats(ssr_stats_t *out);
+
+// One slot elapsed; called from the timer or zero-cross ISR
+void  ssr_slot_isr(void);
+
+#ifndef ESP_PLATFORM
+void  ssr_sim_run(uint32_t slots);
+#endif
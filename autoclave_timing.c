@@ -0,0 +1,166 @@
+/*
+ * ============================================================
+ *  Autoklav — tidsmätning av regler- och sensorloop
+ *
+ *  Tidsstämplar tas från CPU:ns cykelräknare och räknas om
+ *  till µs med en förberäknad reciprok, så en mätpunkt kostar
+ *  en multiplikation och en clz. Histogrammen skrivs bara av
+ *  den mätta tasken; läsare tar en ögonblicksbild och kan se
+ *  högst en mätpunkt halvvägs inskriven.
+ * ============================================================
+ */
+
+#include "autoclave_timing.h"
+#include <string.h>
+
+#ifdef ESP_PLATFORM
+#include "esp_cpu.h"
+#include "sdkconfig.h"
+#define TICKS_PER_US    CONFIG_ESP_DEFAULT_CPU_FREQ_MHZ
+static inline uint32_t now_ticks(void) { return (uint32_t)esp_cpu_get_cycle_count(); }
+#else
+#include <time.h>
+#define TICKS_PER_US    1000u       // Host: nanoseconds
+static inline uint32_t now_ticks(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint32_t)((uint64_t)ts.tv_sec * 1000000000u + (uint64_t)ts.tv_nsec);
+}
+#endif
+
+#define US_RECIP        ((uint32_t)((1ull << 32) / TICKS_PER_US))
+#define TICKS_TO_US(t)  ((uint32_t)(((uint64_t)(t) * US_RECIP) >> 32))
+
+typedef struct {
+    timing_hist_t h;
+    uint32_t period_ticks;      // 0 = free-running, no lateness tracking
+    uint32_t deadline_ticks;
+    uint32_t release;           // Expected start of the current activation
+    uint32_t next_release;
+    uint32_t last_start;
+    bool     started;
+} timing_chan_t;
+
+static timing_chan_t g_chan[TIMING_CHANNELS];
+
+static inline uint32_t bucket(uint32_t us)
+{
+    if (us == 0) return 0;
+    uint32_t b = 32 - (uint32_t)__builtin_clz(us);
+    return b < TIMING_BUCKETS ? b : TIMING_BUCKETS - 1;
+}
+
+void timing_init(void)
+{
+    timing_configure(TIMING_CONTROL, TIMING_CONTROL_PERIOD_US, TIMING_CONTROL_DEADLINE_US);
+    timing_configure(TIMING_SENSOR, TIMING_SENSOR_PERIOD_US, TIMING_SENSOR_DEADLINE_US);
+    timing_configure(TIMING_RENDER, 0, 0);
+}
+
+void timing_configure(timing_ch_t ch, uint32_t period_us, uint32_t deadline_us)
+{
+    timing_chan_t *c = &g_chan[ch];
+    c->period_ticks   = period_us * TICKS_PER_US;
+    c->deadline_ticks = deadline_us * TICKS_PER_US;
+    timing_reset(ch);
+}
+
+void timing_reset(timing_ch_t ch)
+{
+    timing_chan_t *c = &g_chan[ch];
+    memset(&c->h, 0, sizeof(c->h));
+    c->started = false;
+}
+
+uint32_t timing_begin(timing_ch_t ch)
+{
+    uint32_t t = now_ticks();
+    timing_chan_t *c = &g_chan[ch];
+
+    if (c->started) {
+        uint32_t period_us = TICKS_TO_US(t - c->last_start);
+        c->h.period[bucket(period_us)]++;
+        if (period_us > c->h.max_period_us) c->h.max_period_us = period_us;
+    }
+
+    if (c->period_ticks) {
+        if (!c->started) c->next_release = t;
+        c->release = c->next_release;
+        int32_t late = (int32_t)(t - c->release);
+        uint32_t late_us = late > 0 ? TICKS_TO_US((uint32_t)late) : 0;
+        c->h.late[bucket(late_us)]++;
+        if (late_us > c->h.max_late_us) c->h.max_late_us = late_us;
+
+        c->next_release += c->period_ticks;
+        if ((int32_t)(t - c->next_release) >= 0) {
+            // Released a whole period (or more) late: resync the grid
+            uint32_t missed = (t - c->release) / c->period_ticks;
+            c->h.skipped += missed;
+            c->release      += missed * c->period_ticks;
+            c->next_release  = c->release + c->period_ticks;
+        }
+    }
+
+    c->last_start = t;
+    c->started = true;
+    return t;
+}
+
+void timing_end(timing_ch_t ch, uint32_t start)
+{
+    uint32_t t = now_ticks();
+    timing_chan_t *c = &g_chan[ch];
+
+    uint32_t exec_us = TICKS_TO_US(t - start);
+    c->h.exec[bucket(exec_us)]++;
+    if (exec_us > c->h.max_exec_us) c->h.max_exec_us = exec_us;
+    if (c->period_ticks && (int32_t)(t - c->release) > (int32_t)c->deadline_ticks)
+        c->h.deadline_miss++;
+    c->h.samples++;
+}
+
+uint32_t timing_stamp(void)
+{
+    return now_ticks();
+}
+
+uint32_t timing_us_since(uint32_t stamp)
+{
+    return TICKS_TO_US(now_ticks() - stamp);
+}
+
+void timing_snapshot(timing_ch_t ch, timing_hist_t *out)
+{
+    memcpy(out, &g_chan[ch].h, sizeof(*out));
+}
+
+uint32_t timing_percentile_us(const uint32_t hist[TIMING_BUCKETS], uint32_t max_us, int pct)
+{
+    uint32_t total = 0;
+    for (int i = 0; i < TIMING_BUCKETS; i++) total += hist[i];
+    if (total == 0) return 0;
+
+    uint64_t want = ((uint64_t)total * (uint32_t)pct + 99) / 100;
+    uint32_t acc = 0;
+    for (int i = 0; i < TIMING_BUCKETS - 1; i++) {
+        acc += hist[i];
+        if (acc >= want) return 1u << i;          // Bucket upper bound
+    }
+    return max_us;
+}
+
+static uint16_t clamp16(uint32_t v) { return v > 0xFFFF ? 0xFFFF : (uint16_t)v; }
+
+void timing_summarize(timing_ch_t ch, timing_summary_t *out)
+{
+    timing_hist_t h;
+    timing_snapshot(ch, &h);
+    out->samples       = h.samples;
+    out->deadline_miss = h.deadline_miss;
+    out->skipped       = h.skipped;
+    out->exec_p99_us   = clamp16(timing_percentile_us(h.exec, h.max_exec_us, 99));
+    out->late_p99_us   = clamp16(timing_percentile_us(h.late, h.max_late_us, 99));
+    out->max_exec_us   = clamp16(h.max_exec_us);
+    out->max_late_us   = clamp16(h.max_late_us);
+}
@@ -0,0 +1,73 @@
+#pragma once
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+/* ============================================================
+ * Autoclave Control System - loop timing instrumentation
+ * Per channel: period, execution time and release lateness in
+ * log2 µs buckets, plus deadline-miss counters.
+ * timing_init() configures every channel with the periods
+ * below; ui_init() calls it before the tasks start.
+ *
+ *   uint32_t t0 = timing_begin(TIMING_CONTROL);
+ *   ... control step ...
+ *   timing_end(TIMING_CONTROL, t0);
+ * ============================================================ */
+
+typedef enum {
+    TIMING_CONTROL,
+    TIMING_SENSOR,
+    TIMING_RENDER,          // Display refresh, render start to ready
+    TIMING_CHANNELS
+} timing_ch_t;
+
+// Bucket i holds values in [2^(i-1), 2^i) µs; bucket 0 is < 1 µs,
+// the last bucket is open-ended (≥ 16 ms) and reported by its maximum
+#define TIMING_BUCKETS       16
+
+// Release period and deadline per channel; 0 = free-running
+#define TIMING_CONTROL_PERIOD_US     1000000    // One ctrl_step() per second
+#define TIMING_CONTROL_DEADLINE_US   100000
+#define TIMING_SENSOR_PERIOD_US      100000     // One block per SENSOR_CFG block_ms
+#define TIMING_SENSOR_DEADLINE_US    20000
+
+typedef struct {
+    uint32_t period[TIMING_BUCKETS];
+    uint32_t exec[TIMING_BUCKETS];
+    uint32_t late[TIMING_BUCKETS];
+    uint32_t samples;
+    uint32_t deadline_miss;     // Finished later than release + deadline
+    uint32_t skipped;           // Whole periods with no release at all
+    uint32_t max_period_us;
+    uint32_t max_exec_us;
+    uint32_t max_late_us;
+} timing_hist_t;
+
+// Compact form stored with each cycle record
+typedef struct {
+    uint32_t samples;
+    uint32_t deadline_miss;
+    uint32_t skipped;
+    uint16_t exec_p99_us;
+    uint16_t late_p99_us;
+    uint16_t max_exec_us;
+    uint16_t max_late_us;
+} timing_summary_t;
+
+void     timing_init(void);
+void     timing_configure(timing_ch_t ch, uint32_t period_us, uint32_t deadline_us);
+void     timing_reset(timing_ch_t ch);
+uint32_t timing_begin(timing_ch_t ch);
+void     timing_end(timing_ch_t ch, uint32_t start);
+
+// Free-running stamps for ad-hoc measurements (benchmarks)
+uint32_t timing_stamp(void);
+uint32_t timing_us_since(uint32_t stamp);
+
+void     timing_snapshot(timing_ch_t ch, timing_hist_t *out);
+void     timing_summarize(timing_ch_t ch, timing_summary_t *out);
+// Upper bound of the bucket holding the percentile; in the open last
+// bucket that is the largest value seen, 'max_us'
+uint32_t timing_percentile_us(const uint32_t hist[TIMING_BUCKETS], uint32_t max_us, int pct);
@@ -8,14 +8,36 @@
  *    1 · Monitor  — Realtidsdiagram, larmlogg
  *    2 · Program  — Steriliseringsprogram (valbara cykler)
  *    3 · Settings — PID, Nätverk, System
+ *    4 · Översikt — En ruta per autoklav (bara vid flera kammare)
  *
  *  Tema: Material Dark (Android-inspirerat)
  * ============================================================
  */
 
 #include "autoclave_ui.h"
+#include "autoclave_archive.h"
+#include "autoclave_flush.h"
+#include "autoclave_gov.h"
+#include "autoclave_kvs.h"
+#include "autoclave_remote.h"
+#include "autoclave_sched.h"
+#include "autoclave_ssr.h"
+#include "autoclave_timing.h"
+#include <math.h>
 #include <stdio.h>
 #include <string.h>
+#include <time.h>
+
+#ifdef ESP_PLATFORM
+#include "freertos/FreeRTOS.h"
+static portMUX_TYPE g_live_mux = portMUX_INITIALIZER_UNLOCKED;
+#define LIVE_LOCK()     taskENTER_CRITICAL(&g_live_mux)
+#define LIVE_UNLOCK()   taskEXIT_CRITICAL(&g_live_mux)
+#else
+static bool g_live_lock;
+#define LIVE_LOCK()     while (__atomic_test_and_set(&g_live_lock, __ATOMIC_ACQUIRE)) {}
+#define LIVE_UNLOCK()   __atomic_clear(&g_live_lock, __ATOMIC_RELEASE)
+#endif
 
 // ─── Globals ─────────────────────────────────────────────────
 lv_obj_t *g_screen_home;
@@ -29,6 +51,7 @@ lv_obj_t *g_lbl_pressure_value;
 lv_obj_t *g_lbl_status;
 lv_obj_t *g_btn_ssr;
 lv_obj_t *g_lbl_ssr;
+static lv_obj_t *g_lbl_ssr_duty;
 lv_obj_t *g_chart_temp;
 lv_chart_series_t *g_ser_temp;
 
@@ -46,6 +69,164 @@ static lv_obj_t *g_slider_kd;
 static lv_obj_t *g_lbl_kp_val;
 static lv_obj_t *g_lbl_ki_val;
 static lv_obj_t *g_lbl_kd_val;
+static lv_obj_t *g_lbl_setpoint;
+static lv_obj_t *g_lbl_timing[TIMING_CHANNELS];
+static lv_obj_t *g_lbl_flush;
+static lv_obj_t *g_sw_flush;
+static lv_obj_t *g_lbl_gov_level;
+static lv_obj_t *g_lbl_gov_save;
+static lv_obj_t *g_sw_render;
+static lv_obj_t *g_lbl_render_bench;
+static lv_obj_t *g_lbl_home_title;
+static lv_obj_t *g_lbl_monitor_title;
+
+// Persisted settings (defaults until loaded from flash)
+static ui_settings_t g_settings = { 2.5f, 0.8f, 0.3f, 134, false, false };
+
+// ─── Chamber model (struct-of-arrays) ────────────────────────
+#define CHART_POINTS        60
+#define HIST_EMPTY          INT16_MIN
+#define UI_FLUSH_PERIOD_MS  50
+#define SSR_POLL_PERIOD_MS  500
+#define REMOTE_RESYNC_PERIOD_MS 100
+#define BACKLIGHT_FULL_MW   1200    // 4" IPS backlight at 100 %, for the estimate
+
+static lv_timer_t *g_flush_timer;
+static ui_backlight_cb_t g_backlight_cb;
+static bool g_urgent;                   // Urgent change waiting for the next flush
+static volatile bool g_urgent_pending;  // Set from any task, taken by urgent_poll_cb
+static lv_timer_t *g_urgent_timer;
+
+enum {
+    FIELD_TEMP     = 1 << 0,
+    FIELD_PRESSURE = 1 << 1,
+    FIELD_SSR      = 1 << 2,
+    FIELD_STATUS   = 1 << 3,
+    FIELD_CHART    = 1 << 4,
+    FIELD_ALL      = 0x1F,
+};
+
+// dirty and fields[] are set from any task and taken by the flush
+// with atomics. status[] and the chart ring are longer than a word:
+// they are only touched under LIVE_LOCK, for a copy at most.
+static struct {
+    int      count;
+    int      selected;
+    uint32_t dirty;                             // Bit per chamber
+    uint8_t  fields[MAX_CHAMBERS];              // FIELD_* since last flush
+    int16_t  temp_d[MAX_CHAMBERS];              // 0.1 °C, as displayed
+    uint32_t temp_ms[MAX_CHAMBERS];             // lv_tick_get() of the last reading
+    int16_t  pres_c[MAX_CHAMBERS];              // 0.01 bar, as displayed
+    uint8_t  band[MAX_CHAMBERS];                // Colour band, with hysteresis
+    bool     ssr[MAX_CHAMBERS];
+    uint8_t  duty_pct[MAX_CHAMBERS];            // Applied SSR duty
+    char     status[MAX_CHAMBERS][32];
+    int16_t  hist[MAX_CHAMBERS][CHART_POINTS];  // Whole °C, ring
+    int16_t  ref[MAX_CHAMBERS][CHART_POINTS];   // Reference curve, same slots
+    uint8_t  hist_head[MAX_CHAMBERS];
+    uint8_t  hist_new;                          // Selected chamber, not yet charted
+} g_ch = { .count = 1 };
+
+// ─── Cycle runs and archive view ─────────────────────────────
+#define ARCHIVE_PARTITION   "archive"
+#define ARCHIVE_PERIOD_S    5
+#define CYCLE_SAMPLE_PERIOD_MS 1000
+#define ARCHIVE_PAGE        40
+
+static struct {
+    archive_rec_t   *rec[MAX_CHAMBERS];         // NULL = no cycle running
+    int8_t           program[MAX_CHAMBERS];
+    uint32_t         start_ms[MAX_CHAMBERS];
+    uint32_t         next_s[MAX_CHAMBERS];      // Next archive sample, s into the cycle
+    bool             has_ref[MAX_CHAMBERS];
+    archive_cursor_t ref[MAX_CHAMBERS];         // Golden curve, streamed from flash
+    int16_t          ref_now[MAX_CHAMBERS];     // Reference °C at the last sample tick
+} g_run;
+
+static uint32_t  g_chart_view;                  // Archived cycle on the chart, 0 = live
+static lv_chart_series_t *g_ser_ref;
+static lv_obj_t *g_monitor_hdr;
+static lv_obj_t *g_arch_panel;
+static lv_obj_t *g_arch_list;
+static lv_obj_t *g_lbl_arch_btn;
+static lv_obj_t *g_btn_golden;
+static int       g_arch_end;                    // List shows [end - ARCHIVE_PAGE, end)
+static void archive_show_live(void);
+static void archive_list_fill(void);
+
+// ─── Cycle queue ─────────────────────────────────────────────
+#define SCHED_PERIOD_MS     1000
+#define SCHED_STALE_MS      5000    // Older readings don't drive the queue
+#define PROGRAM_POST_S      600     // Venting and drying before the door opens
+#define TIMELINE_ROWS       4
+
+static sched_t          g_sched[MAX_CHAMBERS];
+static ui_setpoint_cb_t g_setpoint_cb;
+static uint32_t         g_abort_req;            // Bit per chamber, set from any task
+static uint8_t          g_abort_result[MAX_CHAMBERS];
+static lv_obj_t *g_lbl_tl_head;
+static lv_obj_t *g_tl_bar;
+static lv_obj_t *g_lbl_tl_row[TIMELINE_ROWS];
+static lv_obj_t *g_btn_tl_ready;
+static lv_obj_t *g_btn_tl_stop;
+static void timeline_refresh(void);
+static void cycle_abort_now(int ch, int result);
+
+// Dashboard tiles
+static lv_obj_t *g_screen_dashboard;
+static lv_obj_t *g_tile_bar[MAX_CHAMBERS];
+static lv_obj_t *g_tile_temp[MAX_CHAMBERS];
+static lv_obj_t *g_tile_pres[MAX_CHAMBERS];
+static lv_obj_t *g_tile_status[MAX_CHAMBERS];
+static lv_obj_t *g_tile_ssr[MAX_CHAMBERS];
+
+// ─── Render profile styles ───────────────────────────────────
+// The expensive primitives live in shared styles; switching the
+// profile edits them in place and every widget re-reads them.
+#define LEAN_RADIUS          4
+#define BTN_SHADOW_W         8
+#define RENDER_BENCH_FRAMES  8
+
+static lv_style_t g_st_card;
+static lv_style_t g_st_button;
+static lv_style_t g_st_arc_card;
+static lv_style_t g_st_nav_pressed;
+static lv_style_transition_dsc_t g_no_transition;
+static bool g_lean;
+
+static void render_styles_init(void)
+{
+    static const lv_style_prop_t no_props[] = { 0 };
+    lv_style_transition_dsc_init(&g_no_transition, no_props, lv_anim_path_linear, 0, 0, NULL);
+
+    lv_style_init(&g_st_card);
+    lv_style_set_border_color(&g_st_card, COLOR_DIVIDER);
+    lv_style_init(&g_st_button);
+    lv_style_set_shadow_opa(&g_st_button, LV_OPA_30);
+    lv_style_init(&g_st_arc_card);
+    lv_style_init(&g_st_nav_pressed);
+}
+
+static void render_styles_apply(bool lean)
+{
+    g_lean = lean;
+    lv_style_set_radius(&g_st_card, lean ? LEAN_RADIUS : CARD_RADIUS);
+    lv_style_set_border_width(&g_st_card, lean ? 0 : 1);
+
+    lv_style_set_radius(&g_st_button, lean ? LEAN_RADIUS : BTN_RADIUS);
+    lv_style_set_shadow_width(&g_st_button, lean ? 0 : BTN_SHADOW_W);
+    if (lean) lv_style_set_transition(&g_st_button, &g_no_transition);
+    else      lv_style_remove_prop(&g_st_button, LV_STYLE_TRANSITION);
+
+    // Lean: no disc behind the arc, the arc alone carries the gauge
+    lv_style_set_radius(&g_st_arc_card, lean ? 0 : LV_RADIUS_CIRCLE);
+    lv_style_set_bg_opa(&g_st_arc_card, lean ? LV_OPA_TRANSP : LV_OPA_COVER);
+
+    lv_style_set_bg_opa(&g_st_nav_pressed, lean ? LV_OPA_COVER : LV_OPA_10);
+    lv_style_set_bg_color(&g_st_nav_pressed, lean ? COLOR_BG_ELEVATED : COLOR_PRIMARY);
+
+    lv_obj_report_style_change(NULL);
+}
 
 // ─── Helper: make a card surface ─────────────────────────────
 static lv_obj_t *make_card(lv_obj_t *parent, int x, int y, int w, int h)
@@ -53,11 +234,9 @@ static lv_obj_t *make_card(lv_obj_t *parent, int x, int y, int w, int h)
     lv_obj_t *card = lv_obj_create(parent);
     lv_obj_set_pos(card, x, y);
     lv_obj_set_size(card, w, h);
+    lv_obj_add_style(card, &g_st_card, 0);
     lv_obj_set_style_bg_color(card, COLOR_BG_SURFACE, 0);
     lv_obj_set_style_bg_opa(card, LV_OPA_COVER, 0);
-    lv_obj_set_style_radius(card, CARD_RADIUS, 0);
-    lv_obj_set_style_border_width(card, 1, 0);
-    lv_obj_set_style_border_color(card, COLOR_DIVIDER, 0);
     lv_obj_set_style_pad_all(card, PADDING_MD, 0);
     lv_obj_clear_flag(card, LV_OBJ_FLAG_SCROLLABLE);
     return card;
@@ -94,10 +273,8 @@ static lv_obj_t *make_button(lv_obj_t *parent, const char *txt,
     lv_obj_set_size(btn, w, h);
     lv_obj_set_style_bg_color(btn, bg, 0);
     lv_obj_set_style_bg_color(btn, lv_color_darken(bg, 40), LV_STATE_PRESSED);
-    lv_obj_set_style_radius(btn, BTN_RADIUS, 0);
-    lv_obj_set_style_shadow_width(btn, 8, 0);
+    lv_obj_add_style(btn, &g_st_button, 0);
     lv_obj_set_style_shadow_color(btn, bg, 0);
-    lv_obj_set_style_shadow_opa(btn, LV_OPA_30, 0);
     lv_obj_set_style_border_width(btn, 0, 0);
     lv_obj_t *lbl = lv_label_create(btn);
     lv_label_set_text(lbl, txt);
@@ -113,12 +290,15 @@ static lv_obj_t *make_button(lv_obj_t *parent, const char *txt,
 // ═══════════════════════════════════════════════════════════════
 typedef struct { const char *icon; const char *label; int idx; } NavItem;
 
+// The dashboard entry is only shown when more than one chamber is set up
 static const NavItem NAV_ITEMS[] = {
+    { LV_SYMBOL_EYE_OPEN, "Översikt",  SCREEN_DASHBOARD },
     { LV_SYMBOL_HOME,     "Hem",       0 },
     { LV_SYMBOL_CHART,    "Monitor",   1 },
     { LV_SYMBOL_LIST,     "Program",   2 },
     { LV_SYMBOL_SETTINGS, "Inställn.", 3 },
 };
+#define NAV_COUNT ((int)(sizeof(NAV_ITEMS) / sizeof(NAV_ITEMS[0])))
 
 static void nav_btn_cb(lv_event_t *e)
 {
@@ -140,14 +320,15 @@ static void create_navbar(lv_obj_t *screen, int active_idx)
     lv_obj_set_style_pad_all(bar, 0, 0);
     lv_obj_clear_flag(bar, LV_OBJ_FLAG_SCROLLABLE);
 
-    int btn_w = SCREEN_W / 4;
-    for (int i = 0; i < 4; i++) {
+    int first = g_ch.count > 1 ? 0 : 1;
+    int btn_w = SCREEN_W / (NAV_COUNT - first);
+    for (int i = first; i < NAV_COUNT; i++) {
+        int pos = i - first;
         lv_obj_t *btn = lv_btn_create(bar);
-        lv_obj_set_pos(btn, i * btn_w, 0);
+        lv_obj_set_pos(btn, pos * btn_w, 0);
         lv_obj_set_size(btn, btn_w, NAVBAR_H);
+        lv_obj_add_style(btn, &g_st_nav_pressed, LV_STATE_PRESSED);
         lv_obj_set_style_bg_opa(btn, LV_OPA_TRANSP, 0);
-        lv_obj_set_style_bg_opa(btn, LV_OPA_10, LV_STATE_PRESSED);
-        lv_obj_set_style_bg_color(btn, COLOR_PRIMARY, LV_STATE_PRESSED);
         lv_obj_set_style_shadow_width(btn, 0, 0);
         lv_obj_set_style_border_width(btn, 0, 0);
         lv_obj_set_style_radius(btn, 0, 0);
@@ -157,7 +338,7 @@ static void create_navbar(lv_obj_t *screen, int active_idx)
         // Icon
         lv_obj_t *icon = lv_label_create(btn);
         lv_label_set_text(icon, NAV_ITEMS[i].icon);
-        bool is_active = (i == active_idx);
+        bool is_active = (NAV_ITEMS[i].idx == active_idx);
         lv_obj_set_style_text_color(icon, is_active ? COLOR_PRIMARY : COLOR_TEXT_DISABLED, 0);
         lv_obj_set_style_text_font(icon, &lv_font_montserrat_20, 0);
         lv_obj_align(icon, LV_ALIGN_CENTER, 0, -8);
@@ -172,7 +353,7 @@ static void create_navbar(lv_obj_t *screen, int active_idx)
         // Active dot indicator
         if (is_active) {
             lv_obj_t *dot = lv_obj_create(bar);
-            lv_obj_set_pos(dot, i * btn_w + btn_w / 2 - 16, 2);
+            lv_obj_set_pos(dot, pos * btn_w + btn_w / 2 - 16, 2);
             lv_obj_set_size(dot, 32, 3);
             lv_obj_set_style_bg_color(dot, COLOR_PRIMARY, 0);
             lv_obj_set_style_radius(dot, 2, 0);
@@ -184,23 +365,45 @@ static void create_navbar(lv_obj_t *screen, int active_idx)
 // ═══════════════════════════════════════════════════════════════
 //  SCREEN 0 — HOME
 // ═══════════════════════════════════════════════════════════════
+static void program_start_cb(lv_event_t *e);
+
+static ui_ssr_cmd_cb_t g_ssr_cmd_cb;
+static lv_timer_t     *g_ssr_poll_timer;
+
+// With a command callback the control task owns every chamber's SSR
+// state, chamber 0 included: the local poll must not overwrite it
+void ui_set_ssr_cmd_cb(ui_ssr_cmd_cb_t cb)
+{
+    g_ssr_cmd_cb = cb;
+    if (!g_ssr_poll_timer) return;
+    if (cb) lv_timer_pause(g_ssr_poll_timer);
+    else    lv_timer_resume(g_ssr_poll_timer);
+}
+
 static void ssr_toggle_cb(lv_event_t *e)
 {
-    // Toggle SSR button appearance
-    static bool ssr_on = false;
-    ssr_on = !ssr_on;
-    lv_obj_t *btn = lv_event_get_target(e);
-    if (ssr_on) {
-        lv_obj_set_style_bg_color(btn, COLOR_ACCENT_WARM, 0);
-        lv_label_set_text(g_lbl_ssr, LV_SYMBOL_POWER "  SSR AV");
-        ui_update_ssr_state(true);
-    } else {
-        lv_obj_set_style_bg_color(btn, COLOR_BG_ELEVATED, 0);
-        lv_label_set_text(g_lbl_ssr, LV_SYMBOL_POWER "  SSR PÅ");
-        ui_update_ssr_state(false);
+    // Only a request: the button follows the state reported back
+    (void)e;
+    int ch = g_ch.selected;
+    bool on = !g_ch.ssr[ch];
+    if (g_ssr_cmd_cb)  g_ssr_cmd_cb(ch, on);
+    else if (ch == 0) {                     // Chamber 0 is this panel's own SSR
+        ssr_enable(on);
+        if (g_ssr_poll_timer) lv_timer_ready(g_ssr_poll_timer);
     }
 }
 
+// Reports the state and the duty the scheduler actually applied
+// to the local SSR, while the UI drives it itself
+static void ssr_poll_cb(lv_timer_t *t)
+{
+    (void)t;
+    if (g_ssr_cmd_cb) return;
+    bool on = ssr_is_enabled();
+    ui_chamber_update_ssr_state(0, on);
+    ui_chamber_update_ssr_duty(0, on ? ssr_get_applied_duty() : 0.0f);
+}
+
 void ui_home_screen_init(void)
 {
     g_screen_home = lv_obj_create(NULL);
@@ -220,6 +423,7 @@ void ui_home_screen_init(void)
 
     lv_obj_t *h_title = lv_label_create(header);
     lv_label_set_text(h_title, "Autoklav Control");
+    g_lbl_home_title = h_title;
     lv_obj_set_style_text_color(h_title, COLOR_TEXT_PRIMARY, 0);
     lv_obj_set_style_text_font(h_title, &lv_font_montserrat_18, 0);
     lv_obj_align(h_title, LV_ALIGN_LEFT_MID, PADDING_LG, 0);
@@ -236,8 +440,8 @@ void ui_home_screen_init(void)
     lv_obj_t *arc_card = lv_obj_create(g_screen_home);
     lv_obj_set_pos(arc_card, SCREEN_W/2 - 170, 64);
     lv_obj_set_size(arc_card, 340, 340);
+    lv_obj_add_style(arc_card, &g_st_arc_card, 0);
     lv_obj_set_style_bg_color(arc_card, COLOR_BG_SURFACE, 0);
-    lv_obj_set_style_radius(arc_card, 170, 0);
     lv_obj_set_style_border_width(arc_card, 0, 0);
     lv_obj_set_style_pad_all(arc_card, 0, 0);
     lv_obj_clear_flag(arc_card, LV_OBJ_FLAG_SCROLLABLE);
@@ -295,9 +499,11 @@ void ui_home_screen_init(void)
     // Setpoint card
     lv_obj_t *sp_card = make_card(g_screen_home, PADDING_MD + 218, card_y, 210, card_h);
     make_card_title(sp_card, LV_SYMBOL_UP "  MÅLTEMP");
-    lv_obj_t *lbl_sp = make_value_label(sp_card, "134", &lv_font_montserrat_32,
-                                          COLOR_ACCENT_YELLOW);
-    lv_obj_align(lbl_sp, LV_ALIGN_LEFT_MID, 0, 10);
+    char sp_txt[8];
+    snprintf(sp_txt, sizeof(sp_txt), "%d", g_settings.setpoint_c);
+    g_lbl_setpoint = make_value_label(sp_card, sp_txt, &lv_font_montserrat_32,
+                                      COLOR_ACCENT_YELLOW);
+    lv_obj_align(g_lbl_setpoint, LV_ALIGN_LEFT_MID, 0, 10);
     lv_obj_t *sp_unit = lv_label_create(sp_card);
     lv_label_set_text(sp_unit, "°C");
     lv_obj_set_style_text_color(sp_unit, COLOR_TEXT_SECONDARY, 0);
@@ -307,18 +513,14 @@ void ui_home_screen_init(void)
     // SSR Toggle card
     lv_obj_t *ssr_card = make_card(g_screen_home, PADDING_MD + 218*2, card_y, 210, card_h);
     make_card_title(ssr_card, "  RELÄ");
-    g_btn_ssr = lv_btn_create(ssr_card);
-    lv_obj_set_size(g_btn_ssr, 174, 52);
+    g_lbl_ssr_duty = make_value_label(ssr_card, "0 %", &lv_font_montserrat_14,
+                                      COLOR_TEXT_SECONDARY);
+    lv_obj_align(g_lbl_ssr_duty, LV_ALIGN_TOP_RIGHT, 0, 0);
+    g_btn_ssr = make_button(ssr_card, LV_SYMBOL_POWER "  SSR PÅ", COLOR_BG_ELEVATED,
+                            174, 52, ssr_toggle_cb);
     lv_obj_align(g_btn_ssr, LV_ALIGN_CENTER, 0, 8);
-    lv_obj_set_style_bg_color(g_btn_ssr, COLOR_BG_ELEVATED, 0);
-    lv_obj_set_style_radius(g_btn_ssr, BTN_RADIUS, 0);
-    lv_obj_set_style_border_width(g_btn_ssr, 0, 0);
-    lv_obj_add_event_cb(g_btn_ssr, ssr_toggle_cb, LV_EVENT_CLICKED, NULL);
-    g_lbl_ssr = lv_label_create(g_btn_ssr);
-    lv_label_set_text(g_lbl_ssr, LV_SYMBOL_POWER "  SSR PÅ");
+    g_lbl_ssr = lv_obj_get_child(g_btn_ssr, 0);
     lv_obj_set_style_text_font(g_lbl_ssr, &lv_font_montserrat_14, 0);
-    lv_obj_set_style_text_color(g_lbl_ssr, COLOR_TEXT_PRIMARY, 0);
-    lv_obj_center(g_lbl_ssr);
 
     /* ── Quick action row ───────────────────────────────────── */
     int qa_y = card_y + card_h + PADDING_MD;
@@ -332,10 +534,14 @@ void ui_home_screen_init(void)
     lv_obj_set_style_text_font(qa_title, &lv_font_montserrat_12, 0);
     lv_obj_align(qa_title, LV_ALIGN_LEFT_MID, 0, 0);
 
+    // Presets queue the matching program (index into PROGRAMS)
     const char *presets[] = {"134°C / 18min", "121°C / 30min", "Torkning"};
+    const int preset_prog[] = { 0, 1, 3 };
     lv_color_t preset_colors[] = { COLOR_ACCENT_WARM, COLOR_PRIMARY, COLOR_ACCENT_GREEN };
     for (int i = 0; i < 3; i++) {
-        lv_obj_t *pb = make_button(qa_card, presets[i], preset_colors[i], 180, 44, NULL);
+        lv_obj_t *pb = make_button(qa_card, presets[i], preset_colors[i], 180, 44,
+                                   program_start_cb);
+        lv_obj_set_user_data(pb, (void *)(intptr_t)preset_prog[i]);
         lv_obj_align(pb, LV_ALIGN_RIGHT_MID, -(i * 190), 0);
     }
 
@@ -360,6 +566,8 @@ void ui_monitor_screen_init(void)
     lv_obj_clear_flag(hdr, LV_OBJ_FLAG_SCROLLABLE);
     lv_obj_t *hdr_lbl = lv_label_create(hdr);
     lv_label_set_text(hdr_lbl, LV_SYMBOL_CHART "  Realtidsmonitor");
+    g_lbl_monitor_title = hdr_lbl;
+    g_monitor_hdr = hdr;
     lv_obj_set_style_text_color(hdr_lbl, COLOR_TEXT_PRIMARY, 0);
     lv_obj_set_style_text_font(hdr_lbl, &lv_font_montserrat_18, 0);
     lv_obj_align(hdr_lbl, LV_ALIGN_LEFT_MID, PADDING_LG, 0);
@@ -390,6 +598,9 @@ void ui_monitor_screen_init(void)
 
     g_ser_temp = lv_chart_add_series(g_chart_temp, COLOR_ACCENT_WARM,
                                       LV_CHART_AXIS_PRIMARY_Y);
+    // Golden reference curve of the running (or viewed) program
+    g_ser_ref = lv_chart_add_series(g_chart_temp, COLOR_TEXT_DISABLED,
+                                     LV_CHART_AXIS_PRIMARY_Y);
     lv_obj_set_style_line_width(g_chart_temp, 3, LV_PART_ITEMS);
     lv_obj_set_style_size(g_chart_temp, 0, 0, LV_PART_INDICATOR);
 
@@ -453,29 +664,228 @@ void ui_monitor_screen_init(void)
 // ═══════════════════════════════════════════════════════════════
 //  SCREEN 2 — PROGRAMS
 // ═══════════════════════════════════════════════════════════════
+typedef struct {
+    int16_t  temp_c;
+    uint16_t hold_min;
+    uint16_t pressure_cbar;     // 1/100 bar
+} ProgramParams;
+
 typedef struct {
     const char *name;
-    const char *temp;
-    const char *time;
-    const char *pressure;
+    ProgramParams p;            // Overridden from flash at boot
     const char *desc;
     lv_color_t color;
 } CycleProgram;
 
-static const CycleProgram PROGRAMS[] = {
-    { "Steril 134°C",  "134°C",  "18 min",  "2.1 bar", "Standard-autoklavering\nför metallinstrument", COLOR_ACCENT_WARM },
-    { "Steril 121°C",  "121°C",  "30 min",  "1.1 bar", "Långsam cykel för\nkänsligt material",        COLOR_PRIMARY },
-    { "Flash-steril",  "134°C",  "4 min",   "2.1 bar", "Snabb cykel för\noförpackade instrument",     COLOR_ACCENT_YELLOW },
-    { "Torkcykel",     "115°C",  "20 min",  "0.7 bar", "Torkning utan\ntryckuppbyggnad",              COLOR_ACCENT_GREEN },
+static CycleProgram PROGRAMS[] = {
+    { "Steril 134°C",  { 134, 18, 210 }, "Standard-autoklavering\nför metallinstrument", COLOR_ACCENT_WARM },
+    { "Steril 121°C",  { 121, 30, 110 }, "Långsam cykel för\nkänsligt material",        COLOR_PRIMARY },
+    { "Flash-steril",  { 134,  4, 210 }, "Snabb cykel för\noförpackade instrument",     COLOR_ACCENT_YELLOW },
+    { "Torkcykel",     { 115, 20,  70 }, "Torkning utan\ntryckuppbyggnad",              COLOR_ACCENT_GREEN },
 };
+#define PROGRAM_COUNT ((int)(sizeof(PROGRAMS) / sizeof(PROGRAMS[0])))
+
+static lv_obj_t *g_lbl_prog_spec[PROGRAM_COUNT];
+static lv_obj_t *g_lbl_prog_start[PROGRAM_COUNT];
+static uint32_t  g_golden[PROGRAM_COUNT];       // Reference cycle ID, 0 = none
 
+// Limits for edited and stored programs
+#define PROGRAM_TEMP_MIN_C  100
+#define PROGRAM_TEMP_MAX_C  140
+#define PROGRAM_HOLD_MAX_MIN 240
+#define PROGRAM_CBAR_MAX    400
+
+static bool program_valid(const ProgramParams *pp)
+{
+    return pp->temp_c >= PROGRAM_TEMP_MIN_C && pp->temp_c <= PROGRAM_TEMP_MAX_C &&
+           pp->hold_min >= 1 && pp->hold_min <= PROGRAM_HOLD_MAX_MIN &&
+           pp->pressure_cbar <= PROGRAM_CBAR_MAX;
+}
+
+static void program_spec_text(int i, char *buf, size_t len)
+{
+    const ProgramParams *pp = &PROGRAMS[i].p;
+    snprintf(buf, len, "%d°C  |  %d min  |  %.1f bar",
+             pp->temp_c, pp->hold_min, pp->pressure_cbar / 100.0f);
+}
+
+// Queues the program; on an idle chamber the load is taken as in
 static void program_start_cb(lv_event_t *e)
 {
-    // In real code: send event to control task
-    lv_obj_t *btn = lv_event_get_target(e);
-    lv_obj_t *lbl = lv_obj_get_child(btn, 0);
-    lv_label_set_text(lbl, LV_SYMBOL_PLAY "  Kör...");
-    lv_obj_set_style_bg_color(btn, COLOR_ACCENT_GREEN, 0);
+    int idx = (int)(intptr_t)lv_obj_get_user_data(lv_event_get_target(e));
+    int ch = g_ch.selected;
+    bool idle = g_sched[ch].count == 0;
+    if (!ui_cycle_enqueue(ch, idx)) {
+        ui_add_log_entry(LV_SYMBOL_WARNING "  Kön är full");
+        return;
+    }
+    if (idle) ui_cycle_load_ready(ch);
+}
+
+// ─── Queue timeline ──────────────────────────────────────────
+#define TIMELINE_H          196
+#define TIMELINE_MIN_S      3600    // Shortest span the bar shows
+
+static const char *const SCHED_PHASE_TEXT[] = {
+    [SCHED_IDLE] = "Ledig",      [SCHED_LOAD] = "Laddning",
+    [SCHED_HEAT] = "Uppvärmning", [SCHED_HOLD] = "Hålltid",
+    [SCHED_POST] = "Torkning",
+};
+
+// Queue clock: seconds since boot, accumulated so it does not wrap
+// with lv_tick_get() after 49.7 days
+static uint32_t sched_clock_s(void)
+{
+    static uint32_t last_tick, ms, s;
+    uint32_t el = lv_tick_elaps(last_tick);
+    last_tick += el;
+    ms += el;
+    s  += ms / 1000;
+    ms %= 1000;
+    return s;
+}
+
+static void clock_text(uint32_t at_s, uint32_t now_s, char *buf, size_t len)
+{
+    time_t t = time(NULL) + (time_t)(at_s - now_s);
+    struct tm tm;
+    strftime(buf, len, "%H:%M", localtime_r(&t, &tm));
+}
+
+static void timeline_ready_cb(lv_event_t *e)
+{
+    (void)e;
+    ui_cycle_load_ready(g_ch.selected);
+}
+
+// A stray tap must not end a sterilisation: stopping takes a long press
+static void timeline_stop_cb(lv_event_t *e)
+{
+    if (lv_event_get_code(e) == LV_EVENT_LONG_PRESSED)
+        cycle_abort_now(g_ch.selected, ARCHIVE_RESULT_ABORTED);
+    else
+        ui_add_log_entry(LV_SYMBOL_STOP "  Håll in Stopp för att avbryta cykeln");
+}
+
+// Drops everything queued behind the running cycle
+static void timeline_clear_cb(lv_event_t *e)
+{
+    (void)e;
+    sched_t *q = &g_sched[g_ch.selected];
+    int keep = q->phase >= SCHED_HEAT ? 1 : 0;
+    while (q->count > keep) sched_remove(q, q->count - 1);
+    timeline_refresh();
+}
+
+static void timeline_segment(int x1, int x2, lv_color_t c, lv_opa_t opa)
+{
+    if (x2 <= x1) return;
+    lv_obj_t *seg = lv_obj_create(g_tl_bar);
+    lv_obj_remove_style_all(seg);
+    lv_obj_set_pos(seg, x1, 0);
+    lv_obj_set_size(seg, x2 - x1, lv_pct(100));
+    lv_obj_set_style_bg_color(seg, c, 0);
+    lv_obj_set_style_bg_opa(seg, opa, 0);
+}
+
+// Bar: heat-up dim, hold and drying solid, gaps are loading
+static void timeline_refresh(void)
+{
+    if (!g_tl_bar) return;
+    int ch = g_ch.selected;
+    const sched_t *q = &g_sched[ch];
+    uint32_t now = sched_clock_s();
+    float temp = g_ch.temp_d[ch] == HIST_EMPTY ? 20.0f : g_ch.temp_d[ch] / 10.0f;
+    sched_slot_t slot[SCHED_MAX_JOBS];
+    int n = sched_plan(q, now, temp, slot, SCHED_MAX_JOBS);
+
+    char buf[96], t1[8], t2[8];
+    if (n) {
+        clock_text(slot[n - 1].end_s, now, t2, sizeof(t2));
+        snprintf(buf, sizeof(buf), "%s  ·  %d i kö  ·  klar ≈ %s",
+                 SCHED_PHASE_TEXT[q->phase], n, t2);
+    } else {
+        snprintf(buf, sizeof(buf), "%s  ·  kön är tom", SCHED_PHASE_TEXT[q->phase]);
+    }
+    lv_label_set_text(g_lbl_tl_head, buf);
+    if (q->phase == SCHED_LOAD && !q->ready) lv_obj_clear_flag(g_btn_tl_ready, LV_OBJ_FLAG_HIDDEN);
+    else                                     lv_obj_add_flag(g_btn_tl_ready, LV_OBJ_FLAG_HIDDEN);
+    if (q->phase >= SCHED_HEAT) lv_obj_clear_flag(g_btn_tl_stop, LV_OBJ_FLAG_HIDDEN);
+    else                        lv_obj_add_flag(g_btn_tl_stop, LV_OBJ_FLAG_HIDDEN);
+
+    lv_obj_clean(g_tl_bar);
+    lv_obj_update_layout(g_tl_bar);
+    int w = lv_obj_get_content_width(g_tl_bar);
+    uint32_t span = n && slot[n - 1].end_s - now > TIMELINE_MIN_S ? slot[n - 1].end_s - now
+                                                                  : TIMELINE_MIN_S;
+    for (int i = 0; i < n; i++) {
+        int xs = slot[i].start_s > now ? (int)((uint64_t)(slot[i].start_s - now) * w / span) : 0;
+        int xh = slot[i].hold_s  > now ? (int)((uint64_t)(slot[i].hold_s  - now) * w / span) : 0;
+        int xe = slot[i].end_s   > now ? (int)((uint64_t)(slot[i].end_s   - now) * w / span) : 0;
+        lv_color_t c = PROGRAMS[slot[i].program].color;
+        timeline_segment(xs, xh, c, LV_OPA_40);
+        timeline_segment(xh, xe, c, LV_OPA_COVER);
+    }
+
+    for (int i = 0; i < TIMELINE_ROWS; i++) {
+        if (i >= n) {
+            lv_label_set_text(g_lbl_tl_row[i], "");
+            continue;
+        }
+        clock_text(slot[i].start_s, now, t1, sizeof(t1));
+        clock_text(slot[i].end_s, now, t2, sizeof(t2));
+        snprintf(buf, sizeof(buf), "%d.  %s – %s   %s%s", i + 1, t1, t2,
+                 PROGRAMS[slot[i].program].name,
+                 i == 0 && q->phase >= SCHED_HEAT ? "   " LV_SYMBOL_PLAY : "");
+        lv_label_set_text(g_lbl_tl_row[i], buf);
+    }
+    if (n > TIMELINE_ROWS) {
+        snprintf(buf, sizeof(buf), "%s   (+%d)", lv_label_get_text(g_lbl_tl_row[TIMELINE_ROWS - 1]),
+                 n - TIMELINE_ROWS);
+        lv_label_set_text(g_lbl_tl_row[TIMELINE_ROWS - 1], buf);
+    }
+
+    for (int i = 0; i < PROGRAM_COUNT; i++)
+        if (g_lbl_prog_start[i])
+            lv_label_set_text(g_lbl_prog_start[i], q->count ? LV_SYMBOL_PLUS "  Kö"
+                                                            : LV_SYMBOL_PLAY "  Starta");
+}
+
+static void timeline_init(int y)
+{
+    lv_obj_t *card = make_card(g_screen_programs, PADDING_MD, y,
+                               SCREEN_W - PADDING_MD*2, TIMELINE_H);
+    make_card_title(card, LV_SYMBOL_LIST "  Kö");
+    g_lbl_tl_head = make_value_label(card, "", &lv_font_montserrat_14, COLOR_TEXT_PRIMARY);
+    lv_obj_align(g_lbl_tl_head, LV_ALIGN_TOP_LEFT, 48, 0);
+
+    lv_obj_t *clr = make_button(card, LV_SYMBOL_TRASH, COLOR_BG_ELEVATED, 48, 32,
+                                timeline_clear_cb);
+    lv_obj_align(clr, LV_ALIGN_TOP_RIGHT, 0, -6);
+    g_btn_tl_ready = make_button(card, LV_SYMBOL_OK "  Laddad", COLOR_ACCENT_GREEN, 130, 32,
+                                 timeline_ready_cb);
+    lv_obj_align(g_btn_tl_ready, LV_ALIGN_TOP_RIGHT, -56, -6);
+    lv_obj_add_flag(g_btn_tl_ready, LV_OBJ_FLAG_HIDDEN);
+    g_btn_tl_stop = make_button(card, LV_SYMBOL_STOP "  Stopp", COLOR_ACCENT_RED, 130, 32, NULL);
+    lv_obj_align(g_btn_tl_stop, LV_ALIGN_TOP_RIGHT, -56, -6);        // Never shown with Laddad
+    lv_obj_add_event_cb(g_btn_tl_stop, timeline_stop_cb, LV_EVENT_SHORT_CLICKED, NULL);
+    lv_obj_add_event_cb(g_btn_tl_stop, timeline_stop_cb, LV_EVENT_LONG_PRESSED, NULL);
+    lv_obj_add_flag(g_btn_tl_stop, LV_OBJ_FLAG_HIDDEN);
+
+    g_tl_bar = lv_obj_create(card);
+    lv_obj_set_pos(g_tl_bar, 0, 36);
+    lv_obj_set_size(g_tl_bar, lv_pct(100), 22);
+    lv_obj_set_style_bg_color(g_tl_bar, COLOR_BG_ELEVATED, 0);
+    lv_obj_set_style_border_width(g_tl_bar, 0, 0);
+    lv_obj_set_style_radius(g_tl_bar, 4, 0);
+    lv_obj_set_style_pad_all(g_tl_bar, 0, 0);
+    lv_obj_clear_flag(g_tl_bar, LV_OBJ_FLAG_SCROLLABLE);
+
+    for (int i = 0; i < TIMELINE_ROWS; i++) {
+        g_lbl_tl_row[i] = make_value_label(card, "", &lv_font_montserrat_13,
+                                           i ? COLOR_TEXT_SECONDARY : COLOR_TEXT_PRIMARY);
+        lv_obj_align(g_lbl_tl_row[i], LV_ALIGN_TOP_LEFT, 0, 68 + i * 22);
+    }
 }
 
 void ui_programs_screen_init(void)
@@ -497,14 +907,15 @@ void ui_programs_screen_init(void)
     lv_obj_set_style_text_font(hdr_l, &lv_font_montserrat_18, 0);
     lv_obj_align(hdr_l, LV_ALIGN_LEFT_MID, PADDING_LG, 0);
 
-    // Program cards
-    int n = sizeof(PROGRAMS) / sizeof(PROGRAMS[0]);
-    int card_h = (CONTENT_H - 56 - PADDING_MD*(n+1)) / n;
+    // Program cards, two per row above the queue timeline
+    int n = PROGRAM_COUNT;
+    int rows = (n + 1) / 2;
+    int card_w = (SCREEN_W - PADDING_MD*3) / 2;
+    int card_h = (CONTENT_H - 56 - TIMELINE_H - PADDING_MD*(rows+2)) / rows;
     for (int i = 0; i < n; i++) {
-        int y = 56 + PADDING_MD + i * (card_h + PADDING_MD);
-        lv_obj_t *pc = make_card(g_screen_programs,
-                                  PADDING_MD, y,
-                                  SCREEN_W - PADDING_MD*2, card_h);
+        int x = PADDING_MD + (i % 2) * (card_w + PADDING_MD);
+        int y = 56 + PADDING_MD + (i / 2) * (card_h + PADDING_MD);
+        lv_obj_t *pc = make_card(g_screen_programs, x, y, card_w, card_h);
 
         // Coloured left accent bar
         lv_obj_t *bar = lv_obj_create(pc);
@@ -530,24 +941,184 @@ void ui_programs_screen_init(void)
 
         // Specs (temp / time / pressure)
         char spec[64];
-        snprintf(spec, sizeof(spec), "%s  |  %s  |  %s",
-                 PROGRAMS[i].temp, PROGRAMS[i].time, PROGRAMS[i].pressure);
+        program_spec_text(i, spec, sizeof(spec));
         lv_obj_t *ps = lv_label_create(pc);
+        g_lbl_prog_spec[i] = ps;
         lv_label_set_text(ps, spec);
         lv_obj_set_style_text_color(ps, PROGRAMS[i].color, 0);
         lv_obj_set_style_text_font(ps, &lv_font_montserrat_12, 0);
-        lv_obj_align(ps, LV_ALIGN_BOTTOM_LEFT, 12, 0);
+        lv_obj_align(ps, LV_ALIGN_BOTTOM_LEFT, 12, -10);
 
-        // Start button
+        // Start button (queues while a cycle is running)
         lv_obj_t *sb = make_button(pc, LV_SYMBOL_PLAY "  Starta",
-                                    PROGRAMS[i].color, 140, 40,
+                                    PROGRAMS[i].color, 120, 40,
                                     program_start_cb);
-        lv_obj_align(sb, LV_ALIGN_RIGHT_MID, 0, 0);
+        lv_obj_set_user_data(sb, (void *)(intptr_t)i);
+        lv_obj_align(sb, LV_ALIGN_BOTTOM_RIGHT, 0, 0);
+        g_lbl_prog_start[i] = lv_obj_get_child(sb, 0);
     }
 
+    timeline_init(56 + PADDING_MD + rows * (card_h + PADDING_MD));
     create_navbar(g_screen_programs, 2);
 }
 
+// ═══════════════════════════════════════════════════════════════
+//  SETTINGS PERSISTENCE
+// ═══════════════════════════════════════════════════════════════
+// Slider drags and roller spins only mark keys dirty; the timer
+// writes them once the operator has let go for a moment. Values
+// read back are range-checked; out of range keeps the default.
+#define SETTINGS_PARTITION      "settings"
+#define SETTINGS_SAVE_DELAY_MS  2000
+#define SETTINGS_RETRY_MS       10000   // After a failed write
+
+enum {
+    KEY_PID         = 0x0001,   // float[3] kp, ki, kd
+    KEY_SETPOINT    = 0x0002,   // int16 °C
+    KEY_RENDER      = 0x0003,   // uint8, 1 = lean
+    KEY_FLUSH       = 0x0004,   // uint8, 1 = flush elision on
+    KEY_PROGRAM     = 0x0100,   // + index, ProgramParams
+    KEY_GOLDEN      = 0x0200,   // + program, uint32 cycle ID
+};
+
+#define DIRTY_PID       (1u << 0)
+#define DIRTY_SETPOINT  (1u << 1)
+#define DIRTY_RENDER    (1u << 2)
+#define DIRTY_FLUSH     (1u << 3)
+#define DIRTY_PROGRAM   (1u << 8)   // << index
+#define DIRTY_GOLDEN    (1u << 16)  // << program
+
+static const int SETPOINT_OPTIONS[] = { 100, 105, 110, 115, 120, 121, 125, 130, 134, 135, 140 };
+#define SETPOINT_OPTION_COUNT ((int)(sizeof(SETPOINT_OPTIONS) / sizeof(SETPOINT_OPTIONS[0])))
+#define PID_GAIN_MAX    100.0f          // Slider range
+
+static bool gain_valid(float g)
+{
+    return isfinite(g) && g >= 0.0f && g <= PID_GAIN_MAX;
+}
+
+static bool setpoint_valid(int sp)
+{
+    for (int i = 0; i < SETPOINT_OPTION_COUNT; i++)
+        if (SETPOINT_OPTIONS[i] == sp) return true;
+    return false;
+}
+
+static lv_timer_t *g_settings_timer;
+static uint32_t    g_settings_dirty;
+static bool        g_settings_ok;
+
+static void settings_save_timer_cb(lv_timer_t *t)
+{
+    (void)t;
+    ui_settings_save();
+}
+
+static void settings_mark_dirty(uint32_t bits)
+{
+    g_settings_dirty |= bits;
+    if (!g_settings_timer) return;
+    lv_timer_set_period(g_settings_timer, SETTINGS_SAVE_DELAY_MS);
+    lv_timer_reset(g_settings_timer);
+    lv_timer_resume(g_settings_timer);
+}
+
+static void settings_load(void)
+{
+    g_settings_ok = kvs_init(flash_part_open(SETTINGS_PARTITION));
+
+    float pid[3];
+    if (kvs_get(KEY_PID, pid, sizeof(pid)) == sizeof(pid) &&
+        gain_valid(pid[0]) && gain_valid(pid[1]) && gain_valid(pid[2])) {
+        g_settings.kp = pid[0];
+        g_settings.ki = pid[1];
+        g_settings.kd = pid[2];
+    }
+    int16_t sp;
+    if (kvs_get(KEY_SETPOINT, &sp, sizeof(sp)) == sizeof(sp) && setpoint_valid(sp))
+        g_settings.setpoint_c = sp;
+    uint8_t lean;
+    if (kvs_get(KEY_RENDER, &lean, sizeof(lean)) == sizeof(lean))
+        g_settings.lean_render = lean != 0;
+    uint8_t elide;
+    if (kvs_get(KEY_FLUSH, &elide, sizeof(elide)) == sizeof(elide))
+        g_settings.flush_elide = elide != 0;
+    for (int i = 0; i < PROGRAM_COUNT; i++) {
+        ProgramParams pp;
+        if (kvs_get(KEY_PROGRAM + i, &pp, sizeof(pp)) == sizeof(pp) && program_valid(&pp))
+            PROGRAMS[i].p = pp;
+        kvs_get(KEY_GOLDEN + i, &g_golden[i], sizeof(g_golden[i]));
+    }
+
+    g_settings_timer = lv_timer_create(settings_save_timer_cb,
+                                       SETTINGS_SAVE_DELAY_MS, NULL);
+    lv_timer_pause(g_settings_timer);
+}
+
+const ui_settings_t *ui_get_settings(void)
+{
+    return &g_settings;
+}
+
+void ui_settings_save(void)
+{
+    if (g_settings_timer) lv_timer_pause(g_settings_timer);
+    uint32_t dirty = g_settings_dirty;
+    g_settings_dirty = 0;
+
+    if (dirty & DIRTY_PID) {
+        float pid[3] = { g_settings.kp, g_settings.ki, g_settings.kd };
+        if (!kvs_set(KEY_PID, pid, sizeof(pid))) g_settings_dirty |= DIRTY_PID;
+    }
+    if (dirty & DIRTY_SETPOINT) {
+        int16_t sp = (int16_t)g_settings.setpoint_c;
+        if (!kvs_set(KEY_SETPOINT, &sp, sizeof(sp))) g_settings_dirty |= DIRTY_SETPOINT;
+    }
+    if (dirty & DIRTY_RENDER) {
+        uint8_t lean = g_settings.lean_render;
+        if (!kvs_set(KEY_RENDER, &lean, sizeof(lean))) g_settings_dirty |= DIRTY_RENDER;
+    }
+    if (dirty & DIRTY_FLUSH) {
+        uint8_t elide = g_settings.flush_elide;
+        if (!kvs_set(KEY_FLUSH, &elide, sizeof(elide))) g_settings_dirty |= DIRTY_FLUSH;
+    }
+    for (int i = 0; i < PROGRAM_COUNT; i++) {
+        if (!(dirty & (DIRTY_PROGRAM << i))) continue;
+        if (!kvs_set(KEY_PROGRAM + i, &PROGRAMS[i].p, sizeof(ProgramParams)))
+            g_settings_dirty |= DIRTY_PROGRAM << i;
+    }
+    for (int i = 0; i < PROGRAM_COUNT; i++) {
+        if (!(dirty & (DIRTY_GOLDEN << i))) continue;
+        if (!kvs_set(KEY_GOLDEN + i, &g_golden[i], sizeof(g_golden[i])))
+            g_settings_dirty |= DIRTY_GOLDEN << i;
+    }
+
+    // Whatever failed stays dirty and is tried again later
+    if (g_settings_dirty && g_settings_timer) {
+        lv_timer_set_period(g_settings_timer, SETTINGS_RETRY_MS);
+        lv_timer_reset(g_settings_timer);
+        lv_timer_resume(g_settings_timer);
+    }
+}
+
+void ui_set_program(int idx, int temp_c, int hold_min, float bar)
+{
+    if (idx < 0 || idx >= PROGRAM_COUNT) return;
+    if (temp_c < PROGRAM_TEMP_MIN_C || temp_c > PROGRAM_TEMP_MAX_C ||
+        hold_min < 1 || hold_min > PROGRAM_HOLD_MAX_MIN ||
+        !isfinite(bar) || bar < 0.0f || bar * 100.0f > PROGRAM_CBAR_MAX) return;
+    ProgramParams *pp = &PROGRAMS[idx].p;
+    pp->temp_c        = (int16_t)temp_c;
+    pp->hold_min      = (uint16_t)hold_min;
+    pp->pressure_cbar = (uint16_t)(bar * 100.0f + 0.5f);
+    if (g_lbl_prog_spec[idx]) {
+        char spec[64];
+        program_spec_text(idx, spec, sizeof(spec));
+        lv_label_set_text(g_lbl_prog_spec[idx], spec);
+    }
+    settings_mark_dirty(DIRTY_PROGRAM << idx);
+}
+
 // ═══════════════════════════════════════════════════════════════
 //  SCREEN 3 — SETTINGS
 // ═══════════════════════════════════════════════════════════════
@@ -555,9 +1126,155 @@ static void slider_pid_cb(lv_event_t *e)
 {
     lv_obj_t *sl = lv_event_get_target(e);
     lv_obj_t *lbl = (lv_obj_t *)lv_event_get_user_data(e);
+    float val = (float)lv_slider_get_value(sl) / 10.0f;
     char buf[16];
-    snprintf(buf, sizeof(buf), "%.1f", (float)lv_slider_get_value(sl) / 10.0f);
+    snprintf(buf, sizeof(buf), "%.1f", val);
     lv_label_set_text(lbl, buf);
+
+    if      (sl == g_slider_kp) g_settings.kp = val;
+    else if (sl == g_slider_ki) g_settings.ki = val;
+    else if (sl == g_slider_kd) g_settings.kd = val;
+    settings_mark_dirty(DIRTY_PID);
+}
+
+static void roller_sp_cb(lv_event_t *e)
+{
+    uint32_t sel = lv_roller_get_selected(lv_event_get_target(e));
+    if (sel >= (uint32_t)SETPOINT_OPTION_COUNT) return;
+    g_settings.setpoint_c = SETPOINT_OPTIONS[sel];
+    if (g_lbl_setpoint) {
+        char buf[8];
+        snprintf(buf, sizeof(buf), "%d", g_settings.setpoint_c);
+        lv_label_set_text(g_lbl_setpoint, buf);
+    }
+    settings_mark_dirty(DIRTY_SETPOINT);
+}
+
+static void timing_refresh_cb(lv_timer_t *t)
+{
+    (void)t;
+    if (lv_scr_act() != g_screen_settings) return;
+
+    static const char *names[TIMING_CHANNELS] = { "Reglering", "Sensor", "Rendering" };
+    for (int i = 0; i < TIMING_CHANNELS; i++) {
+        timing_summary_t ts;
+        timing_summarize((timing_ch_t)i, &ts);
+        char buf[96];
+        snprintf(buf, sizeof(buf),
+                 "%-10s n=%lu   exek %u/%u µs   sen %u/%u µs   missar %lu",
+                 names[i], (unsigned long)ts.samples,
+                 ts.exec_p99_us, ts.max_exec_us,
+                 ts.late_p99_us, ts.max_late_us,
+                 (unsigned long)(ts.deadline_miss + ts.skipped));
+        lv_label_set_text(g_lbl_timing[i], buf);
+    }
+
+    // Panel transfers skipped by flush elision, share of bytes
+    flush_elide_stats_t fs;
+    flush_elide_get_stats(&fs);
+    uint64_t total = fs.bytes_sent + fs.bytes_elided;
+    char buf[96];
+    if (!flush_elide_is_enabled())
+        snprintf(buf, sizeof(buf), "%-10s av", "Flush");
+    else
+        snprintf(buf, sizeof(buf), "%-10s skickat %lu   hoppat %lu   sparat %u %%",
+                 "Flush", (unsigned long)fs.segments_sent, (unsigned long)fs.segments_elided,
+                 total ? (unsigned)(fs.bytes_elided * 100 / total) : 0u);
+    lv_label_set_text(g_lbl_flush, buf);
+
+    // Refresh governor: share of time per level and what it saved
+    static const char *levels[GOV_LEVELS] = { "aktiv", "vila", "nedtonad" };
+    gov_stats_t gs;
+    gov_get_stats(lv_tick_get(), &gs);
+    uint32_t span = gs.ms[GOV_ACTIVE] + gs.ms[GOV_IDLE] + gs.ms[GOV_DIM];
+    uint64_t render_us = gs.render_us[GOV_ACTIVE] + gs.render_us[GOV_IDLE] + gs.render_us[GOV_DIM];
+    if (!span) span = 1;
+    snprintf(buf, sizeof(buf), "Nu %-9s aktiv %u %%   vila %u %%   nedtonad %u %%",
+             levels[gov_level()], (unsigned)((uint64_t)gs.ms[GOV_ACTIVE] * 100 / span),
+             (unsigned)((uint64_t)gs.ms[GOV_IDLE] * 100 / span),
+             (unsigned)((uint64_t)gs.ms[GOV_DIM] * 100 / span));
+    lv_label_set_text(g_lbl_gov_level, buf);
+    snprintf(buf, sizeof(buf), "Väckningar -%u %%   rendering %u.%u %% CPU   ljus -%u %% (%u mW)",
+             gs.wakeups_full ? (unsigned)(100 - (uint64_t)gs.wakeups * 100 / gs.wakeups_full) : 0u,
+             (unsigned)(render_us / span / 10), (unsigned)(render_us / span % 10),
+             (unsigned)(100 - gs.backlight_pct_avg),
+             (unsigned)((100 - gs.backlight_pct_avg) * BACKLIGHT_FULL_MW / 100));
+    lv_label_set_text(g_lbl_gov_save, buf);
+}
+
+void ui_set_render_profile(bool lean)
+{
+    render_styles_apply(lean);
+    if (g_sw_render) {
+        if (lean) lv_obj_add_state(g_sw_render, LV_STATE_CHECKED);
+        else      lv_obj_clear_state(g_sw_render, LV_STATE_CHECKED);
+    }
+    if (g_settings.lean_render != lean) {
+        g_settings.lean_render = lean;
+        settings_mark_dirty(DIRTY_RENDER);
+    }
+}
+
+static void render_switch_cb(lv_event_t *e)
+{
+    ui_set_render_profile(lv_obj_has_state(lv_event_get_target(e), LV_STATE_CHECKED));
+}
+
+void ui_set_flush_elision(bool on)
+{
+    flush_elide_enable(on);
+    if (g_sw_flush) {
+        if (on) lv_obj_add_state(g_sw_flush, LV_STATE_CHECKED);
+        else    lv_obj_clear_state(g_sw_flush, LV_STATE_CHECKED);
+    }
+    if (g_settings.flush_elide != on) {
+        g_settings.flush_elide = on;
+        settings_mark_dirty(DIRTY_FLUSH);
+    }
+}
+
+static void flush_switch_cb(lv_event_t *e)
+{
+    ui_set_flush_elision(lv_obj_has_state(lv_event_get_target(e), LV_STATE_CHECKED));
+}
+
+// Mean time to redraw the whole active screen
+static uint32_t render_bench_frame_us(void)
+{
+    uint32_t total = 0;
+    for (int i = 0; i < RENDER_BENCH_FRAMES; i++) {
+        lv_obj_invalidate(lv_scr_act());
+        uint32_t t0 = timing_stamp();
+        lv_refr_now(NULL);
+        total += timing_us_since(t0);
+    }
+    return total / RENDER_BENCH_FRAMES;
+}
+
+static void render_bench_cb(lv_event_t *e)
+{
+    (void)e;
+    bool lean = g_lean;
+    render_styles_apply(false);
+    uint32_t full_us = render_bench_frame_us();
+    render_styles_apply(true);
+    uint32_t lean_us = render_bench_frame_us();
+    render_styles_apply(lean);
+
+    int saved = full_us ? (int)(100 - (uint64_t)lean_us * 100 / full_us) : 0;
+    char buf[80];
+    snprintf(buf, sizeof(buf), "Full %lu.%lu ms · Lätt %lu.%lu ms per bild (%d %% mindre)",
+             (unsigned long)(full_us / 1000), (unsigned long)(full_us % 1000 / 100),
+             (unsigned long)(lean_us / 1000), (unsigned long)(lean_us % 1000 / 100), saved);
+    lv_label_set_text(g_lbl_render_bench, buf);
+}
+
+static void save_btn_cb(lv_event_t *e)
+{
+    (void)e;
+    ui_settings_save();
+    ui_add_log_entry(g_settings_dirty ? LV_SYMBOL_WARNING "  Kunde inte spara inställningar"
+                                      : LV_SYMBOL_SAVE "  Inställningar sparade");
 }
 
 static lv_obj_t *make_pid_row(lv_obj_t *parent, const char *name,
@@ -655,11 +1372,11 @@ void ui_settings_screen_init(void)
     lv_obj_set_style_text_font(pid_title, &lv_font_montserrat_14, 0);
     lv_obj_align(pid_title, LV_ALIGN_TOP_LEFT, 0, 0);
 
-    make_pid_row(pid_card, "Kp  (Proportional)", 2.5f, 32,
+    make_pid_row(pid_card, "Kp  (Proportional)", g_settings.kp, 32,
                  &g_slider_kp, &g_lbl_kp_val);
-    make_pid_row(pid_card, "Ki  (Integral)",      0.8f, 94,
+    make_pid_row(pid_card, "Ki  (Integral)",      g_settings.ki, 94,
                  &g_slider_ki, &g_lbl_ki_val);
-    make_pid_row(pid_card, "Kd  (Derivata)",      0.3f, 156,
+    make_pid_row(pid_card, "Kd  (Derivata)",      g_settings.kd, 156,
                  &g_slider_kd, &g_lbl_kd_val);
 
     // Setpoint roller
@@ -674,7 +1391,11 @@ void ui_settings_screen_init(void)
     lv_roller_set_options(sp_roller,
         "100\n105\n110\n115\n120\n121\n125\n130\n134\n135\n140",
         LV_ROLLER_MODE_NORMAL);
-    lv_roller_set_selected(sp_roller, 8, LV_ANIM_OFF); // 134
+    uint32_t sp_sel = 8; // 134
+    for (int i = 0; i < SETPOINT_OPTION_COUNT; i++)
+        if (SETPOINT_OPTIONS[i] == g_settings.setpoint_c) sp_sel = i;
+    lv_roller_set_selected(sp_roller, sp_sel, LV_ANIM_OFF);
+    lv_obj_add_event_cb(sp_roller, roller_sp_cb, LV_EVENT_VALUE_CHANGED, NULL);
     lv_obj_set_size(sp_roller, 120, 64);
     lv_obj_align(sp_roller, LV_ALIGN_RIGHT_MID, 0, 8);
     lv_obj_set_style_bg_color(sp_roller, COLOR_BG_ELEVATED, 0);
@@ -685,7 +1406,7 @@ void ui_settings_screen_init(void)
 
     // Save button
     lv_obj_t *save_btn = make_button(tab_pid, LV_SYMBOL_SAVE "  Spara PID",
-                                      COLOR_PRIMARY, 200, 44, NULL);
+                                      COLOR_PRIMARY, 200, 44, save_btn_cb);
     lv_obj_align(save_btn, LV_ALIGN_BOTTOM_MID, 0, -PADDING_MD);
 
     // ─── NETWORK TAB ─────────────────────────────────────────
@@ -766,32 +1487,820 @@ void ui_settings_screen_init(void)
         lv_obj_align(vl, LV_ALIGN_RIGHT_MID, 0, 0);
     }
 
-    // Action buttons
+    // Loop timing (p99 / max per channel)
+    lv_obj_t *tm_card = make_card(tab_sys, 0, 208, lv_pct(100), 140);
+    make_card_title(tm_card, LV_SYMBOL_LOOP "  Looptider (p99 / max)");
+    for (int i = 0; i < TIMING_CHANNELS; i++) {
+        g_lbl_timing[i] = make_value_label(tm_card, "-", &lv_font_montserrat_13,
+                                           COLOR_TEXT_PRIMARY);
+        lv_obj_align(g_lbl_timing[i], LV_ALIGN_TOP_LEFT, 0, 24 + i * 22);
+    }
+    g_lbl_flush = make_value_label(tm_card, "-", &lv_font_montserrat_13, COLOR_TEXT_PRIMARY);
+    lv_obj_align(g_lbl_flush, LV_ALIGN_TOP_LEFT, 0, 24 + TIMING_CHANNELS * 22);
+    g_sw_flush = lv_switch_create(tm_card);
+    lv_obj_set_size(g_sw_flush, 52, 28);
+    lv_obj_align(g_sw_flush, LV_ALIGN_TOP_RIGHT, 0, 18 + TIMING_CHANNELS * 22);
+    lv_obj_set_style_bg_color(g_sw_flush, COLOR_PRIMARY, LV_PART_INDICATOR | LV_STATE_CHECKED);
+    if (g_settings.flush_elide) lv_obj_add_state(g_sw_flush, LV_STATE_CHECKED);
+    lv_obj_add_event_cb(g_sw_flush, flush_switch_cb, LV_EVENT_VALUE_CHANGED, NULL);
+    lv_timer_create(timing_refresh_cb, 1000, NULL);
+
+    // Render profile
+    lv_obj_t *rp_card = make_card(tab_sys, 0, 356, lv_pct(100), 96);
+    make_card_title(rp_card, LV_SYMBOL_IMAGE "  Lätt rendering");
+    g_sw_render = lv_switch_create(rp_card);
+    lv_obj_set_size(g_sw_render, 52, 28);
+    lv_obj_align(g_sw_render, LV_ALIGN_TOP_RIGHT, 0, -4);
+    lv_obj_set_style_bg_color(g_sw_render, COLOR_PRIMARY, LV_PART_INDICATOR | LV_STATE_CHECKED);
+    if (g_lean) lv_obj_add_state(g_sw_render, LV_STATE_CHECKED);
+    lv_obj_add_event_cb(g_sw_render, render_switch_cb, LV_EVENT_VALUE_CHANGED, NULL);
+
+    g_lbl_render_bench = make_value_label(rp_card, "Inga skuggor, rundningar eller animationer",
+                                          &lv_font_montserrat_13, COLOR_TEXT_SECONDARY);
+    lv_obj_align(g_lbl_render_bench, LV_ALIGN_BOTTOM_LEFT, 0, 0);
+    lv_obj_t *bench_btn = make_button(rp_card, LV_SYMBOL_PLAY "  Mät", COLOR_BG_ELEVATED,
+                                      90, 32, render_bench_cb);
+    lv_obj_align(bench_btn, LV_ALIGN_BOTTOM_RIGHT, 0, 4);
+
+    // Refresh governor
+    lv_obj_t *gv_card = make_card(tab_sys, 0, 460, lv_pct(100), 96);
+    make_card_title(gv_card, LV_SYMBOL_EYE_OPEN "  Uppdateringstakt");
+    g_lbl_gov_level = make_value_label(gv_card, "-", &lv_font_montserrat_13, COLOR_TEXT_PRIMARY);
+    lv_obj_align(g_lbl_gov_level, LV_ALIGN_TOP_LEFT, 0, 24);
+    g_lbl_gov_save = make_value_label(gv_card, "-", &lv_font_montserrat_13, COLOR_TEXT_PRIMARY);
+    lv_obj_align(g_lbl_gov_save, LV_ALIGN_TOP_LEFT, 0, 46);
+
+    // Action buttons (below the cards; the tab scrolls)
     lv_obj_t *reboot_btn = make_button(tab_sys, LV_SYMBOL_REFRESH "  Starta om",
                                         COLOR_ACCENT_YELLOW, 200, 44, NULL);
-    lv_obj_align(reboot_btn, LV_ALIGN_BOTTOM_LEFT, 0, -PADDING_MD);
+    lv_obj_align(reboot_btn, LV_ALIGN_TOP_LEFT, 0, 572);
 
     lv_obj_t *reset_btn  = make_button(tab_sys, LV_SYMBOL_CLOSE "  Fabriksåterst.",
                                         COLOR_ACCENT_RED, 200, 44, NULL);
-    lv_obj_align(reset_btn, LV_ALIGN_BOTTOM_RIGHT, 0, -PADDING_MD);
+    lv_obj_align(reset_btn, LV_ALIGN_TOP_RIGHT, 0, 572);
 
     create_navbar(g_screen_settings, 3);
 }
 
+// ═══════════════════════════════════════════════════════════════
+//  SCREEN 4 — DASHBOARD (multi-chamber)
+// ═══════════════════════════════════════════════════════════════
+static void tile_click_cb(lv_event_t *e)
+{
+    ui_select_chamber((int)(intptr_t)lv_event_get_user_data(e));
+    ui_navigate_to(0);
+}
+
+void ui_dashboard_screen_init(void)
+{
+    g_screen_dashboard = lv_obj_create(NULL);
+    lv_obj_set_style_bg_color(g_screen_dashboard, COLOR_BG_BASE, 0);
+    lv_obj_clear_flag(g_screen_dashboard, LV_OBJ_FLAG_SCROLLABLE);
+
+    // Header
+    lv_obj_t *hdr = lv_obj_create(g_screen_dashboard);
+    lv_obj_set_pos(hdr, 0, 0); lv_obj_set_size(hdr, SCREEN_W, 56);
+    lv_obj_set_style_bg_color(hdr, COLOR_BG_SURFACE, 0);
+    lv_obj_set_style_border_width(hdr, 0, 0);
+    lv_obj_set_style_radius(hdr, 0, 0);
+    lv_obj_clear_flag(hdr, LV_OBJ_FLAG_SCROLLABLE);
+    lv_obj_t *hdr_l = lv_label_create(hdr);
+    lv_label_set_text(hdr_l, LV_SYMBOL_EYE_OPEN "  Översikt");
+    lv_obj_set_style_text_color(hdr_l, COLOR_TEXT_PRIMARY, 0);
+    lv_obj_set_style_text_font(hdr_l, &lv_font_montserrat_18, 0);
+    lv_obj_align(hdr_l, LV_ALIGN_LEFT_MID, PADDING_LG, 0);
+
+    /* ── Chamber tiles, two columns ─────────────────────────── */
+    int n = g_ch.count;
+    int rows = (n + 1) / 2;
+    int tw = (SCREEN_W - PADDING_MD * 3) / 2;
+    int th = (CONTENT_H - 56 - PADDING_MD * (rows + 1)) / rows;
+    for (int i = 0; i < n; i++) {
+        int x = PADDING_MD + (i % 2) * (tw + PADDING_MD);
+        int y = 56 + PADDING_MD + (i / 2) * (th + PADDING_MD);
+        lv_obj_t *tc = make_card(g_screen_dashboard, x, y, tw, th);
+        lv_obj_add_flag(tc, LV_OBJ_FLAG_CLICKABLE);
+        lv_obj_set_style_bg_color(tc, COLOR_BG_ELEVATED, LV_STATE_PRESSED);
+        lv_obj_add_event_cb(tc, tile_click_cb, LV_EVENT_CLICKED, (void *)(intptr_t)i);
+
+        // Left accent bar, coloured by temperature band
+        g_tile_bar[i] = lv_obj_create(tc);
+        lv_obj_set_pos(g_tile_bar[i], -PADDING_MD, -PADDING_MD);
+        lv_obj_set_size(g_tile_bar[i], 4, th);
+        lv_obj_set_style_bg_color(g_tile_bar[i], COLOR_TEXT_DISABLED, 0);
+        lv_obj_set_style_radius(g_tile_bar[i], 0, 0);
+        lv_obj_set_style_border_width(g_tile_bar[i], 0, 0);
+        lv_obj_clear_flag(g_tile_bar[i], LV_OBJ_FLAG_CLICKABLE);
+
+        char name[16];
+        snprintf(name, sizeof(name), "Autoklav %d", i + 1);
+        lv_obj_t *tn = make_card_title(tc, name);
+        lv_obj_set_x(tn, 8);
+
+        g_tile_status[i] = make_value_label(tc, "", &lv_font_montserrat_12,
+                                            COLOR_TEXT_SECONDARY);
+        lv_obj_align(g_tile_status[i], LV_ALIGN_TOP_RIGHT, 0, 0);
+
+        g_tile_temp[i] = make_value_label(tc, "---", &lv_font_montserrat_32,
+                                          COLOR_TEXT_PRIMARY);
+        lv_obj_align(g_tile_temp[i], LV_ALIGN_LEFT_MID, 8, 4);
+
+        g_tile_pres[i] = make_value_label(tc, "--.-- bar", &lv_font_montserrat_14,
+                                          COLOR_PRIMARY);
+        lv_obj_align(g_tile_pres[i], LV_ALIGN_BOTTOM_LEFT, 8, 0);
+
+        g_tile_ssr[i] = make_value_label(tc, LV_SYMBOL_POWER " SSR", &lv_font_montserrat_12,
+                                         COLOR_TEXT_DISABLED);
+        lv_obj_align(g_tile_ssr[i], LV_ALIGN_BOTTOM_RIGHT, 0, 0);
+    }
+
+    create_navbar(g_screen_dashboard, SCREEN_DASHBOARD);
+}
+
 // ═══════════════════════════════════════════════════════════════
 //  NAVIGATION
 // ═══════════════════════════════════════════════════════════════
 void ui_navigate_to(int idx)
 {
-    lv_obj_t *screens[] = {
+    lv_obj_t *screens[SCREEN_COUNT] = {
         g_screen_home,
         g_screen_monitor,
         g_screen_programs,
-        g_screen_settings
+        g_screen_settings,
+        g_screen_dashboard
     };
-    if (idx < 0 || idx > 3) return;
+    if (idx < 0 || idx >= SCREEN_COUNT || !screens[idx]) return;
     g_active_screen = idx;
-    lv_scr_load_anim(screens[idx], LV_SCR_LOAD_ANIM_FADE_ON, 200, 0, false);
+    if (g_lean) lv_scr_load(screens[idx]);
+    else        lv_scr_load_anim(screens[idx], LV_SCR_LOAD_ANIM_FADE_ON, 200, 0, false);
+}
+
+// ═══════════════════════════════════════════════════════════════
+//  CHAMBERS
+// ═══════════════════════════════════════════════════════════════
+#define BAND_HYST_C     1.0f
+
+static const float BAND_EDGES[] = { 80.0f, 120.0f, 140.0f };
+
+// Moves up at an edge, but back down only once the reading is
+// BAND_HYST_C below it, so a value sitting on 120 °C can't flicker
+static uint8_t temp_band(uint8_t prev, float temp_c)
+{
+    uint8_t b = 0;
+    while (b < 3 && temp_c >= BAND_EDGES[b]) b++;
+    if (b < prev && temp_c >= BAND_EDGES[prev - 1] - BAND_HYST_C) return prev;
+    return b;
+}
+
+static lv_color_t temp_color(uint8_t band)
+{
+    // Colour: blue→cyan→orange→red
+    switch (band) {
+    case 0:  return COLOR_PRIMARY;
+    case 1:  return COLOR_ACCENT_YELLOW;
+    case 2:  return COLOR_ACCENT_WARM;
+    default: return COLOR_ACCENT_RED;
+    }
+}
+
+static void chamber_model_init(void)
+{
+    for (int i = 0; i < MAX_CHAMBERS; i++) {
+        g_ch.temp_d[i] = HIST_EMPTY;
+        g_ch.pres_c[i] = HIST_EMPTY;
+        for (int k = 0; k < CHART_POINTS; k++) g_ch.hist[i][k] = g_ch.ref[i][k] = HIST_EMPTY;
+        g_run.ref_now[i] = HIST_EMPTY;
+    }
+}
+
+static void chamber_mark(int ch, uint8_t fields)
+{
+    if (!fields) return;
+    __atomic_fetch_or(&g_ch.fields[ch], fields, __ATOMIC_RELAXED);
+    __atomic_fetch_or(&g_ch.dirty, 1u << ch, __ATOMIC_RELEASE);
+}
+
+void ui_chamber_set_count(int n)
+{
+    if (n < 1) n = 1;
+    if (n > MAX_CHAMBERS) n = MAX_CHAMBERS;
+    g_ch.count = n;
+}
+
+int ui_get_selected_chamber(void)
+{
+    return g_ch.selected;
+}
+
+// Reloads the chart from the chamber's history ring
+static void chart_reload(int ch)
+{
+    if (!g_chart_temp || !g_ser_temp) return;
+    int16_t hist[CHART_POINTS], ref[CHART_POINTS];
+    LIVE_LOCK();
+    int head = g_ch.hist_head[ch];
+    memcpy(hist, g_ch.hist[ch], sizeof(hist));
+    memcpy(ref, g_ch.ref[ch], sizeof(ref));
+    g_ch.hist_new = 0;
+    LIVE_UNLOCK();
+    for (int k = 0; k < CHART_POINTS; k++) {
+        int slot = (head + k) % CHART_POINTS;
+        int16_t v = hist[slot], r = ref[slot];
+        lv_chart_set_next_value(g_chart_temp, g_ser_temp,
+                                v == HIST_EMPTY ? LV_CHART_POINT_NONE : v);
+        lv_chart_set_next_value(g_chart_temp, g_ser_ref,
+                                r == HIST_EMPTY ? LV_CHART_POINT_NONE : r);
+    }
+}
+
+// Pushes only the samples that arrived since the last flush
+static void chart_sync(int ch)
+{
+    if (!g_chart_temp || !g_ser_temp || g_chart_view) return;
+    int16_t hist[CHART_POINTS], ref[CHART_POINTS];
+    LIVE_LOCK();
+    int head = g_ch.hist_head[ch], n = g_ch.hist_new;
+    for (int k = 0; k < n; k++) {
+        int slot = (head - n + k + CHART_POINTS) % CHART_POINTS;
+        hist[k] = g_ch.hist[ch][slot];
+        ref[k] = g_ch.ref[ch][slot];
+    }
+    g_ch.hist_new = 0;
+    LIVE_UNLOCK();
+    for (int k = 0; k < n; k++) {
+        lv_chart_set_next_value(g_chart_temp, g_ser_temp, hist[k]);
+        lv_chart_set_next_value(g_chart_temp, g_ser_ref,
+                                ref[k] == HIST_EMPTY ? LV_CHART_POINT_NONE : ref[k]);
+    }
+}
+
+void ui_select_chamber(int ch)
+{
+    if (ch < 0 || ch >= g_ch.count) return;
+    g_ch.selected = ch;
+    if (g_chart_view) archive_show_live();
+
+    if (g_ch.count > 1) {
+        char buf[48];
+        snprintf(buf, sizeof(buf), "Autoklav %d", ch + 1);
+        if (g_lbl_home_title) lv_label_set_text(g_lbl_home_title, buf);
+        snprintf(buf, sizeof(buf), LV_SYMBOL_CHART "  Realtidsmonitor · Autoklav %d", ch + 1);
+        if (g_lbl_monitor_title) lv_label_set_text(g_lbl_monitor_title, buf);
+    }
+    chart_reload(ch);
+    timeline_refresh();
+    chamber_mark(ch, FIELD_ALL & ~FIELD_CHART);
+}
+
+static void status_copy(int ch, char *out, size_t n)
+{
+    LIVE_LOCK();
+    snprintf(out, n, "%s", g_ch.status[ch]);
+    LIVE_UNLOCK();
+}
+
+static void tile_render(int i, uint8_t f)
+{
+    if (!g_tile_temp[i]) return;
+    char buf[32];
+    if ((f & FIELD_TEMP) && g_ch.temp_d[i] != HIST_EMPTY) {
+        float t = g_ch.temp_d[i] / 10.0f;
+        snprintf(buf, sizeof(buf), "%.1f °C", t);
+        lv_label_set_text(g_tile_temp[i], buf);
+        lv_obj_set_style_bg_color(g_tile_bar[i], temp_color(g_ch.band[i]), 0);
+    }
+    if ((f & FIELD_PRESSURE) && g_ch.pres_c[i] != HIST_EMPTY) {
+        snprintf(buf, sizeof(buf), "%.2f bar", g_ch.pres_c[i] / 100.0f);
+        lv_label_set_text(g_tile_pres[i], buf);
+    }
+    if (f & FIELD_SSR) {
+        snprintf(buf, sizeof(buf), LV_SYMBOL_POWER " %d %%", g_ch.duty_pct[i]);
+        lv_label_set_text(g_tile_ssr[i], buf);
+        lv_obj_set_style_text_color(g_tile_ssr[i],
+            g_ch.ssr[i] ? COLOR_ACCENT_WARM : COLOR_TEXT_DISABLED, 0);
+    }
+    if (f & FIELD_STATUS) {
+        status_copy(i, buf, sizeof(buf));
+        lv_label_set_text(g_tile_status[i], buf);
+    }
+}
+
+static void home_render(int ch, uint8_t f)
+{
+    // The widgets are shared by all chambers: a chamber without data
+    // yet must blank them, not leave the previous chamber's values
+    char buf[16];
+    if ((f & FIELD_TEMP) && g_arc_temp && g_lbl_temp_value) {
+        if (g_ch.temp_d[ch] == HIST_EMPTY) {
+            lv_arc_set_value(g_arc_temp, 0);
+            lv_label_set_text(g_lbl_temp_value, "---");
+        } else {
+            float temp_c = g_ch.temp_d[ch] / 10.0f;
+
+            // Arc range 0–150°C mapped to 0–100 arc value
+            int arc_val = (int)(temp_c / 150.0f * 100.0f);
+            if (arc_val < 0)   arc_val = 0;
+            if (arc_val > 100) arc_val = 100;
+            lv_arc_set_value(g_arc_temp, arc_val);
+            lv_obj_set_style_arc_color(g_arc_temp, temp_color(g_ch.band[ch]), LV_PART_INDICATOR);
+
+            snprintf(buf, sizeof(buf), "%.1f", temp_c);
+            lv_label_set_text(g_lbl_temp_value, buf);
+        }
+    }
+    if ((f & FIELD_PRESSURE) && g_lbl_pressure_value) {
+        if (g_ch.pres_c[ch] == HIST_EMPTY) {
+            lv_label_set_text(g_lbl_pressure_value, "--.-");
+        } else {
+            snprintf(buf, sizeof(buf), "%.2f", g_ch.pres_c[ch] / 100.0f);
+            lv_label_set_text(g_lbl_pressure_value, buf);
+        }
+    }
+    if ((f & FIELD_SSR) && g_btn_ssr) {
+        bool on = g_ch.ssr[ch];
+        lv_color_t bg = on ? COLOR_ACCENT_WARM : COLOR_BG_ELEVATED;
+        lv_obj_set_style_bg_color(g_btn_ssr, bg, 0);
+        lv_obj_set_style_bg_color(g_btn_ssr, lv_color_darken(bg, 40), LV_STATE_PRESSED);
+        lv_obj_set_style_shadow_color(g_btn_ssr, bg, 0);
+        lv_label_set_text(g_lbl_ssr, on ? LV_SYMBOL_POWER "  SSR AV"
+                                        : LV_SYMBOL_POWER "  SSR PÅ");
+        snprintf(buf, sizeof(buf), "%d %%", g_ch.duty_pct[ch]);
+        lv_label_set_text(g_lbl_ssr_duty, buf);
+    }
+    if ((f & FIELD_STATUS) && g_lbl_status) {
+        char status[sizeof(g_ch.status[ch])];
+        status_copy(ch, status, sizeof(status));
+        lv_label_set_text(g_lbl_status, status);
+    }
+    if (f & FIELD_CHART)
+        chart_sync(ch);
+}
+
+// Visits only the chambers whose bit is set
+static void chamber_flush_cb(lv_timer_t *t)
+{
+    (void)t;
+    gov_step(lv_tick_get(), lv_anim_count_running() > 0);
+    uint32_t dirty = __atomic_exchange_n(&g_ch.dirty, 0, __ATOMIC_ACQUIRE);
+    while (dirty) {
+        int i = __builtin_ctz(dirty);
+        dirty &= dirty - 1;
+        uint8_t f = __atomic_exchange_n(&g_ch.fields[i], 0, __ATOMIC_ACQUIRE);
+        tile_render(i, f);
+        if (i == g_ch.selected) home_render(i, f);
+    }
+    // Don't wait out the refresh period with an alarm on screen
+    if (g_urgent) {
+        g_urgent = false;
+        lv_display_t *disp = lv_display_get_default();
+        if (disp) lv_timer_ready(lv_display_get_refr_timer(disp));
+    }
+}
+
+// ═══════════════════════════════════════════════════════════════
+//  CYCLE ARCHIVE
+// ═══════════════════════════════════════════════════════════════
+static const char *result_text(uint8_t r)
+{
+    switch (r) {
+    case ARCHIVE_RESULT_OK:      return "OK";
+    case ARCHIVE_RESULT_ABORTED: return "Avbruten";
+    default:                     return "Fel";
+    }
+}
+
+static const char *program_name(uint8_t p)
+{
+    return p < PROGRAM_COUNT ? PROGRAMS[p].name : "?";
+}
+
+static bool open_golden(int program, uint32_t skip_id, archive_cursor_t *c)
+{
+    const archive_entry_t *g = NULL;
+    if (program >= 0 && program < PROGRAM_COUNT && g_golden[program] != skip_id)
+        g = archive_find_id(g_golden[program]);
+    if (g) archive_cursor_open(c, g);
+    return g != NULL;
+}
+
+void ui_cycle_start(int ch, int program)
+{
+    if (ch < 0 || ch >= g_ch.count || program < 0 || program >= PROGRAM_COUNT) return;
+    archive_discard(g_run.rec[ch]);
+    g_run.rec[ch]      = archive_begin((uint8_t)program, (uint8_t)ch, ARCHIVE_PERIOD_S);
+    g_run.program[ch]  = (int8_t)program;
+    g_run.start_ms[ch] = lv_tick_get();
+    g_run.next_s[ch]   = 0;
+    g_run.has_ref[ch]  = open_golden(program, 0, &g_run.ref[ch]);
+    g_run.ref_now[ch]  = HIST_EMPTY;
+    if (ch == 0) timing_reset(TIMING_CONTROL);   // Per-cycle loop timing
+
+    char buf[64];
+    snprintf(buf, sizeof(buf), LV_SYMBOL_PLAY "  %s startad", PROGRAMS[program].name);
+    ui_add_log_entry(buf);
+}
+
+void ui_cycle_end(int ch, int result)
+{
+    if (ch < 0 || ch >= g_ch.count || !g_run.rec[ch]) return;
+    if (result != ARCHIVE_RESULT_OK && g_sched[ch].phase >= SCHED_HEAT) {
+        cycle_abort_now(ch, result);        // Stops the queue, then comes back here
+        return;
+    }
+    timing_summary_t ts;
+    if (ch == 0) timing_summarize(TIMING_CONTROL, &ts);
+    uint32_t id = archive_end(g_run.rec[ch], (archive_result_t)result, ch == 0 ? &ts : NULL);
+    g_run.rec[ch] = NULL;
+    g_run.has_ref[ch] = false;
+    g_run.ref_now[ch] = HIST_EMPTY;
+
+    char buf[64];
+    if (id) snprintf(buf, sizeof(buf), LV_SYMBOL_SAVE "  Cykel #%lu arkiverad (%s)",
+                     (unsigned long)id, result_text((uint8_t)result));
+    else    snprintf(buf, sizeof(buf), LV_SYMBOL_WARNING "  Cykeln kunde inte arkiveras");
+    ui_add_log_entry(buf);
+    if (g_arch_panel && !lv_obj_has_flag(g_arch_panel, LV_OBJ_FLAG_HIDDEN)) {
+        g_arch_end = archive_count();
+        archive_list_fill();
+    }
+}
+
+// Archives the stored values when a sample is due and looks up the
+// reference for now. Flash is only touched here, on the LVGL
+// thread; the update API just copies ref_now into the chart ring.
+static void cycle_sample_cb(lv_timer_t *t)
+{
+    (void)t;
+    for (int ch = 0; ch < g_ch.count; ch++) {
+        if (!g_run.rec[ch] || g_ch.temp_d[ch] == HIST_EMPTY) continue;
+        uint32_t el = lv_tick_elaps(g_run.start_ms[ch]) / 1000;
+        float temp_c = g_ch.temp_d[ch] / 10.0f;
+        float bar = g_ch.pres_c[ch] == HIST_EMPTY ? 0.0f : g_ch.pres_c[ch] / 100.0f;
+        while (el >= g_run.next_s[ch]) {
+            archive_add(g_run.rec[ch], temp_c, bar);
+            g_run.next_s[ch] += ARCHIVE_PERIOD_S;
+        }
+        archive_sample_t s;
+        g_run.ref_now[ch] = g_run.has_ref[ch] && archive_cursor_at_time(&g_run.ref[ch], el, &s)
+                          ? (int16_t)(s.temp_d / 10) : HIST_EMPTY;
+    }
+}
+
+// Back to the live chart; the caller reloads it (ui_select_chamber)
+static void archive_show_live(void)
+{
+    g_chart_view = 0;
+    lv_label_set_text(g_lbl_monitor_title, LV_SYMBOL_CHART "  Realtidsmonitor");
+    lv_label_set_text(g_lbl_arch_btn, LV_SYMBOL_DIRECTORY "  Arkiv");
+    lv_obj_add_flag(g_btn_golden, LV_OBJ_FLAG_HIDDEN);
+}
+
+// Streams CHART_POINTS evenly spaced samples of the cycle, and the
+// golden curve at the same instants, into the chart
+static void archive_show_cycle(uint32_t id)
+{
+    const archive_entry_t *e = archive_find_id(id);
+    if (!e) return;
+    g_chart_view = id;
+
+    archive_cursor_t cur, gold;
+    archive_cursor_open(&cur, e);
+    bool has_gold = open_golden(e->program, id, &gold);
+    uint32_t stride = (e->samples + CHART_POINTS - 1) / CHART_POINTS;
+    if (stride == 0) stride = 1;
+
+    archive_sample_t pts[CHART_POINTS];
+    size_t n = archive_cursor_read(&cur, 0, CHART_POINTS, stride, pts);
+    for (int k = 0; k < CHART_POINTS; k++) {
+        archive_sample_t g;
+        bool gv = has_gold && archive_cursor_at_time(&gold, k * stride * e->period_s, &g);
+        lv_chart_set_next_value(g_chart_temp, g_ser_temp,
+                                (size_t)k < n ? pts[k].temp_d / 10 : LV_CHART_POINT_NONE);
+        lv_chart_set_next_value(g_chart_temp, g_ser_ref,
+                                gv ? g.temp_d / 10 : LV_CHART_POINT_NONE);
+    }
+
+    char when[24], buf[96];
+    time_t t = e->start_time;
+    struct tm tm;
+    strftime(when, sizeof(when), "%Y-%m-%d %H:%M", localtime_r(&t, &tm));
+    snprintf(buf, sizeof(buf), LV_SYMBOL_DIRECTORY "  #%lu · %s · %s · %s",
+             (unsigned long)id, program_name(e->program), when, result_text(e->result));
+    lv_label_set_text(g_lbl_monitor_title, buf);
+    lv_label_set_text(g_lbl_arch_btn, LV_SYMBOL_LEFT "  Live");
+    if (e->result == ARCHIVE_RESULT_OK) lv_obj_clear_flag(g_btn_golden, LV_OBJ_FLAG_HIDDEN);
+    else                                lv_obj_add_flag(g_btn_golden, LV_OBJ_FLAG_HIDDEN);
+}
+
+static void archive_row_cb(lv_event_t *e)
+{
+    lv_obj_add_flag(g_arch_panel, LV_OBJ_FLAG_HIDDEN);
+    archive_show_cycle((uint32_t)(uintptr_t)lv_event_get_user_data(e));
+}
+
+// Newest first, one page ending at g_arch_end
+static void archive_list_fill(void)
+{
+    lv_obj_clean(g_arch_list);
+    int n = archive_count();
+    if (g_arch_end > n) g_arch_end = n;
+    if (g_arch_end < 1 && n > 0) g_arch_end = n < ARCHIVE_PAGE ? n : ARCHIVE_PAGE;
+    int first = g_arch_end - ARCHIVE_PAGE < 0 ? 0 : g_arch_end - ARCHIVE_PAGE;
+    for (int i = g_arch_end - 1; i >= first; i--) {
+        const archive_entry_t *e = archive_at(i);
+        char when[24], buf[96];
+        time_t t = e->start_time;
+        struct tm tm;
+        strftime(when, sizeof(when), "%Y-%m-%d %H:%M", localtime_r(&t, &tm));
+        snprintf(buf, sizeof(buf), "#%-5lu %s   %-14s %s%s", (unsigned long)e->id, when,
+                 program_name(e->program), result_text(e->result),
+                 e->program < PROGRAM_COUNT && g_golden[e->program] == e->id ? "  ★" : "");
+        lv_obj_t *row = lv_list_add_button(g_arch_list, NULL, buf);
+        lv_obj_set_style_bg_color(row, COLOR_BG_SURFACE, 0);
+        lv_obj_set_style_text_color(row, e->result == ARCHIVE_RESULT_OK ? COLOR_TEXT_PRIMARY
+                                                                        : COLOR_ACCENT_RED, 0);
+        lv_obj_set_style_text_font(row, &lv_font_montserrat_13, 0);
+        lv_obj_add_event_cb(row, archive_row_cb, LV_EVENT_CLICKED,
+                            (void *)(uintptr_t)e->id);
+    }
+    if (n == 0) lv_list_add_text(g_arch_list, "Inga arkiverade cykler");
+}
+
+static void archive_btn_cb(lv_event_t *e)
+{
+    (void)e;
+    if (g_chart_view) {
+        ui_select_chamber(g_ch.selected);
+        return;
+    }
+    g_arch_end = archive_count();
+    archive_list_fill();
+    lv_obj_clear_flag(g_arch_panel, LV_OBJ_FLAG_HIDDEN);
+}
+
+static void archive_close_cb(lv_event_t *e)
+{
+    (void)e;
+    lv_obj_add_flag(g_arch_panel, LV_OBJ_FLAG_HIDDEN);
+}
+
+// Paging (±page) and date jumps: 0 = since local midnight,
+// otherwise that many days back from midnight
+static void archive_nav_cb(lv_event_t *e)
+{
+    int arg = (int)(intptr_t)lv_event_get_user_data(e);
+    if (arg == -1)      g_arch_end -= ARCHIVE_PAGE;
+    else if (arg == 1)  g_arch_end += ARCHIVE_PAGE;
+    else {
+        time_t now = time(NULL);
+        struct tm tm;
+        localtime_r(&now, &tm);
+        tm.tm_hour = tm.tm_min = tm.tm_sec = 0;
+        tm.tm_mday -= arg;
+        tm.tm_isdst = -1;
+        g_arch_end = archive_find_time((uint32_t)mktime(&tm)) + ARCHIVE_PAGE;
+    }
+    if (g_arch_end < ARCHIVE_PAGE) g_arch_end = ARCHIVE_PAGE;
+    archive_list_fill();
+}
+
+static void golden_btn_cb(lv_event_t *e)
+{
+    (void)e;
+    const archive_entry_t *a = archive_find_id(g_chart_view);
+    if (!a || a->program >= PROGRAM_COUNT) return;
+    if (a->result != ARCHIVE_RESULT_OK) {
+        ui_add_log_entry(LV_SYMBOL_WARNING "  Bara godkända cykler kan bli referens");
+        return;
+    }
+    g_golden[a->program] = a->id;
+    settings_mark_dirty(DIRTY_GOLDEN << a->program);
+    for (int ch = 0; ch < g_ch.count; ch++)
+        if (g_run.rec[ch] && g_run.program[ch] == a->program)
+            g_run.has_ref[ch] = open_golden(a->program, 0, &g_run.ref[ch]);
+
+    char buf[64];
+    snprintf(buf, sizeof(buf), LV_SYMBOL_OK "  #%lu är referens för %s",
+             (unsigned long)a->id, PROGRAMS[a->program].name);
+    ui_add_log_entry(buf);
+}
+
+// Header buttons and the list panel on the monitor screen
+static void archive_view_init(void)
+{
+    if (!archive_init(flash_part_open(ARCHIVE_PARTITION)))
+        ui_add_log_entry(LV_SYMBOL_WARNING "  Cykelarkivet kunde inte läsas");
+
+    lv_obj_t *ab = make_button(g_monitor_hdr, LV_SYMBOL_DIRECTORY "  Arkiv",
+                               COLOR_BG_ELEVATED, 120, 36, archive_btn_cb);
+    lv_obj_align(ab, LV_ALIGN_RIGHT_MID, -PADDING_MD, 0);
+    g_lbl_arch_btn = lv_obj_get_child(ab, 0);
+
+    g_btn_golden = make_button(g_monitor_hdr, LV_SYMBOL_OK "  Referens",
+                               COLOR_BG_ELEVATED, 130, 36, golden_btn_cb);
+    lv_obj_align(g_btn_golden, LV_ALIGN_RIGHT_MID, -PADDING_MD - 128, 0);
+    lv_obj_add_flag(g_btn_golden, LV_OBJ_FLAG_HIDDEN);
+
+    int ph = CONTENT_H - 68 - PADDING_MD;
+    g_arch_panel = make_card(g_screen_monitor, PADDING_MD, 68, SCREEN_W - PADDING_MD * 2, ph);
+    lv_obj_set_style_bg_color(g_arch_panel, COLOR_BG_ELEVATED, 0);
+    lv_obj_add_flag(g_arch_panel, LV_OBJ_FLAG_HIDDEN);
+    make_card_title(g_arch_panel, LV_SYMBOL_DIRECTORY "  Arkiverade cykler");
+
+    lv_obj_t *close = make_button(g_arch_panel, LV_SYMBOL_CLOSE, COLOR_BG_SURFACE,
+                                  44, 32, archive_close_cb);
+    lv_obj_align(close, LV_ALIGN_TOP_RIGHT, 0, -6);
+
+    g_arch_list = lv_list_create(g_arch_panel);
+    lv_obj_set_size(g_arch_list, lv_pct(100), ph - PADDING_MD * 2 - 36 - 52);
+    lv_obj_align(g_arch_list, LV_ALIGN_TOP_MID, 0, 36);
+    lv_obj_set_style_bg_color(g_arch_list, COLOR_BG_SURFACE, 0);
+    lv_obj_set_style_border_width(g_arch_list, 0, 0);
+
+    static const struct { const char *txt; int arg; } nav[] = {
+        { LV_SYMBOL_LEFT "  Äldre", -1 }, { "30 d", 30 }, { "7 d", 7 },
+        { "Idag", 0 },                    { "Nyare  " LV_SYMBOL_RIGHT, 1 },
+    };
+    int bw = (SCREEN_W - PADDING_MD * 4 - PADDING_SM * 4) / 5;
+    for (int i = 0; i < 5; i++) {
+        lv_obj_t *b = make_button(g_arch_panel, nav[i].txt, COLOR_BG_SURFACE, bw, 44, NULL);
+        lv_obj_align(b, LV_ALIGN_BOTTOM_LEFT, i * (bw + PADDING_SM), 0);
+        lv_obj_add_event_cb(b, archive_nav_cb, LV_EVENT_CLICKED, (void *)(intptr_t)nav[i].arg);
+    }
+}
+
+static void render_event_cb(lv_event_t *e)
+{
+    static uint32_t t0;
+    if (lv_event_get_code(e) == LV_EVENT_RENDER_START) {
+        t0 = timing_begin(TIMING_RENDER);
+    } else {
+        timing_end(TIMING_RENDER, t0);
+        gov_note_frame(timing_us_since(t0));
+    }
+}
+
+// A remote viewer connected or fell behind: redraw everything
+static void remote_resync_cb(lv_timer_t *t)
+{
+    (void)t;
+    if (remote_view_take_resync()) lv_obj_invalidate(lv_scr_act());
+}
+
+// ═══════════════════════════════════════════════════════════════
+//  CYCLE QUEUE
+// ═══════════════════════════════════════════════════════════════
+bool ui_cycle_enqueue(int ch, int program)
+{
+    if (ch < 0 || ch >= g_ch.count || program < 0 || program >= PROGRAM_COUNT) return false;
+    const ProgramParams *pp = &PROGRAMS[program].p;
+    sched_job_t job = {
+        .program = (uint8_t)program, .setpoint_c = pp->temp_c,
+        .hold_s = pp->hold_min * 60u, .post_s = PROGRAM_POST_S,
+    };
+    if (!sched_enqueue(&g_sched[ch], &job)) return false;
+
+    char buf[64];
+    snprintf(buf, sizeof(buf), LV_SYMBOL_LIST "  %s köad (%d)", PROGRAMS[program].name,
+             g_sched[ch].count);
+    ui_add_log_entry(buf);
+    if (ch == g_ch.selected) timeline_refresh();
+    return true;
+}
+
+// LVGL thread only: archives and redraws
+static void cycle_abort_now(int ch, int result)
+{
+    if (ch < 0 || ch >= g_ch.count) return;
+    bool running = g_sched[ch].phase >= SCHED_HEAT;
+    sched_abort(&g_sched[ch]);
+    if (g_setpoint_cb) g_setpoint_cb(ch, -1.0f);
+    ui_cycle_end(ch, result);
+    if (running) ui_chamber_update_status(ch, LV_SYMBOL_STOP "  Cykeln avbruten");
+    if (ch == g_ch.selected) timeline_refresh();
+}
+
+// Only raises the request; sched_tick_cb carries it out
+void ui_cycle_abort(int ch, int result)
+{
+    if (ch < 0 || ch >= g_ch.count) return;
+    __atomic_store_n(&g_abort_result[ch], (uint8_t)result, __ATOMIC_RELAXED);
+    __atomic_fetch_or(&g_abort_req, 1u << ch, __ATOMIC_RELEASE);
+}
+
+void ui_cycle_load_ready(int ch)
+{
+    if (ch < 0 || ch >= g_ch.count) return;
+    sched_load_ready(&g_sched[ch]);
+    if (ch == g_ch.selected) timeline_refresh();
+}
+
+void ui_set_setpoint_cb(ui_setpoint_cb_t cb)
+{
+    g_setpoint_cb = cb;
+}
+
+void ui_set_chamber_model(int ch, const fopdt_model_t *m)
+{
+    if (ch >= 0 && ch < g_ch.count) sched_set_model(&g_sched[ch], m);
+}
+
+// Steps every chamber's queue and hands setpoint changes on
+static void sched_tick_cb(lv_timer_t *t)
+{
+    (void)t;
+    static uint8_t n;
+    uint32_t now = sched_clock_s();
+    bool refresh = ++n % 10 == 0 && lv_scr_act() == g_screen_programs;
+    uint32_t req = __atomic_exchange_n(&g_abort_req, 0, __ATOMIC_ACQUIRE);
+    while (req) {
+        int ch = __builtin_ctz(req);
+        req &= req - 1;
+        cycle_abort_now(ch, __atomic_load_n(&g_abort_result[ch], __ATOMIC_RELAXED));
+    }
+    for (int ch = 0; ch < g_ch.count; ch++) {
+        bool fresh = g_ch.temp_d[ch] != HIST_EMPTY && lv_tick_elaps(g_ch.temp_ms[ch]) < SCHED_STALE_MS;
+        sched_out_t o = sched_step(&g_sched[ch], now, fresh ? g_ch.temp_d[ch] / 10.0f : NAN);
+        if (o.cycle_started) ui_cycle_start(ch, o.program);
+        if (o.cycle_done)    ui_cycle_end(ch, ARCHIVE_RESULT_OK);
+        if (o.hold_restarted)
+            ui_add_log_entry(LV_SYMBOL_WARNING "  Temperaturdipp, hålltiden börjar om");
+        if (!o.changed) continue;
+        if (g_setpoint_cb) g_setpoint_cb(ch, o.setpoint_c);
+        if (o.phase == SCHED_LOAD && o.setpoint_c > 0)
+            ui_chamber_update_status(ch, LV_SYMBOL_LOOP "  Förvärmd, väntar på last");
+        else if (o.phase != SCHED_IDLE)
+            ui_chamber_update_status(ch, SCHED_PHASE_TEXT[o.phase]);
+        else
+            ui_chamber_update_status(ch, LV_SYMBOL_OK "  Standby");
+        refresh |= ch == g_ch.selected;
+    }
+    if (refresh) timeline_refresh();
+}
+
+static void queue_init(void)
+{
+    sched_cfg_t cfg = SCHED_CFG_DEFAULT;
+    for (int ch = 0; ch < MAX_CHAMBERS; ch++) sched_init(&g_sched[ch], &cfg);
+}
+
+// ═══════════════════════════════════════════════════════════════
+//  REFRESH GOVERNOR
+// ═══════════════════════════════════════════════════════════════
+static void gov_apply_cb(gov_level_t level, const gov_profile_t *p)
+{
+    (void)level;
+    lv_display_t *disp = lv_display_get_default();
+    if (disp) lv_timer_set_period(lv_display_get_refr_timer(disp), p->refr_ms);
+    if (g_flush_timer) lv_timer_set_period(g_flush_timer, p->update_ms);
+    for (lv_indev_t *in = lv_indev_get_next(NULL); in; in = lv_indev_get_next(in))
+        lv_timer_set_period(lv_indev_get_read_timer(in), p->indev_ms);
+    if (g_urgent_timer) lv_timer_set_period(g_urgent_timer, p->indev_ms);
+    if (g_backlight_cb) g_backlight_cb(p->backlight_pct);
+}
+
+static void gov_input_cb(lv_event_t *e)
+{
+    (void)e;
+    gov_note_input(lv_tick_get());
+}
+
+// Alarm-relevant change. Called from the update API, so possibly
+// from another task: only raise the flag for urgent_poll_cb.
+static void chamber_urgent(void)
+{
+    __atomic_store_n(&g_urgent_pending, true, __ATOMIC_RELEASE);
+}
+
+// Full rate, backlight up, flush right away; polled at the touch
+// read rate, so it adds no sleep longer than the loop already has
+static void urgent_poll_cb(lv_timer_t *t)
+{
+    (void)t;
+    if (!__atomic_exchange_n(&g_urgent_pending, false, __ATOMIC_ACQ_REL)) return;
+    gov_note_urgent(lv_tick_get());
+    g_urgent = true;
+    if (g_flush_timer) lv_timer_ready(g_flush_timer);
+}
+
+void ui_set_backlight_cb(ui_backlight_cb_t cb)
+{
+    g_backlight_cb = cb;
+    if (cb) cb(gov_profile(gov_level())->backlight_pct);
+}
+
+void ui_set_dim_timeout(uint32_t ms)
+{
+    gov_set_dim_timeout(ms);
+}
+
+// Input devices registered after ui_init() are not hooked
+static void governor_init(void)
+{
+    for (lv_indev_t *in = lv_indev_get_next(NULL); in; in = lv_indev_get_next(in))
+        lv_indev_add_event_cb(in, gov_input_cb, LV_EVENT_PRESSED, NULL);
+    g_urgent_timer = lv_timer_create(urgent_poll_cb, gov_profile(GOV_ACTIVE)->indev_ms, NULL);
+    gov_init(gov_apply_cb, lv_tick_get());
 }
 
 // ═══════════════════════════════════════════════════════════════
@@ -802,65 +2311,125 @@ void ui_init(void)
     // Enable montserrat fonts in lv_conf.h:
     //   LV_FONT_MONTSERRAT_10, 12, 13, 14, 16, 18, 20, 48 = 1
 
+    timing_init();
+    settings_load();
+    render_styles_init();
+    render_styles_apply(g_settings.lean_render);
+    if (flush_elide_init(SCREEN_H, 2))          // RGB565
+        flush_elide_enable(g_settings.flush_elide);
+    chamber_model_init();
+    queue_init();
+
     ui_home_screen_init();
     ui_monitor_screen_init();
+    archive_view_init();
     ui_programs_screen_init();
     ui_settings_screen_init();
+    if (g_ch.count > 1) {
+        ui_dashboard_screen_init();
+        ui_select_chamber(0);
+    }
 
-    lv_scr_load(g_screen_home);
+    kvs_stats_t ks;
+    kvs_get_stats(&ks);
+    if (ks.compact_failed)
+        ui_add_log_entry(LV_SYMBOL_WARNING "  Inställningar kan inte sparas");
+    else if (!g_settings_ok)
+        ui_add_log_entry(LV_SYMBOL_WARNING "  Inställningar kunde inte läsas");
+
+    g_flush_timer = lv_timer_create(chamber_flush_cb, UI_FLUSH_PERIOD_MS, NULL);
+    g_ssr_poll_timer = lv_timer_create(ssr_poll_cb, SSR_POLL_PERIOD_MS, NULL);
+    if (g_ssr_cmd_cb) lv_timer_pause(g_ssr_poll_timer);
+    lv_timer_create(sched_tick_cb, SCHED_PERIOD_MS, NULL);
+    lv_timer_create(cycle_sample_cb, CYCLE_SAMPLE_PERIOD_MS, NULL);
+    lv_timer_create(remote_resync_cb, REMOTE_RESYNC_PERIOD_MS, NULL);
+
+    lv_display_t *disp = lv_display_get_default();
+    if (disp) {
+        lv_display_add_event_cb(disp, render_event_cb, LV_EVENT_RENDER_START, NULL);
+        lv_display_add_event_cb(disp, render_event_cb, LV_EVENT_RENDER_READY, NULL);
+    }
+    governor_init();
+    lv_scr_load(g_ch.count > 1 ? g_screen_dashboard : g_screen_home);
 }
 
 // ═══════════════════════════════════════════════════════════════
 //  LIVE DATA UPDATE API
 // ═══════════════════════════════════════════════════════════════
-void ui_update_temperature(float temp_c)
+void ui_chamber_update_temperature(int ch, float temp_c)
 {
-    if (!g_arc_temp || !g_lbl_temp_value) return;
-
-    // Arc range 0–150°C mapped to 0–100 arc value
-    int arc_val = (int)(temp_c / 150.0f * 100.0f);
-    if (arc_val < 0)   arc_val = 0;
-    if (arc_val > 100) arc_val = 100;
-    lv_arc_set_value(g_arc_temp, arc_val);
-
-    // Colour: blue→cyan→orange→red
-    lv_color_t col;
-    if      (temp_c < 80)  col = COLOR_PRIMARY;
-    else if (temp_c < 120) col = COLOR_ACCENT_YELLOW;
-    else if (temp_c < 140) col = COLOR_ACCENT_WARM;
-    else                   col = COLOR_ACCENT_RED;
-    lv_obj_set_style_arc_color(g_arc_temp, col, LV_PART_INDICATOR);
-
-    char buf[16];
-    snprintf(buf, sizeof(buf), "%.1f", temp_c);
-    lv_label_set_text(g_lbl_temp_value, buf);
+    if (ch < 0 || ch >= g_ch.count) return;
+    uint8_t f = 0;
+
+    int16_t d = (int16_t)(temp_c * 10.0f + (temp_c < 0 ? -0.5f : 0.5f));
+    g_ch.temp_ms[ch] = lv_tick_get();
+    if (d != g_ch.temp_d[ch]) {
+        g_ch.temp_d[ch] = d;
+        uint8_t band = temp_band(g_ch.band[ch], temp_c);
+        if (band != g_ch.band[ch]) chamber_urgent();
+        g_ch.band[ch] = band;
+        f |= FIELD_TEMP;
+    }
 
-    // Also push to chart
-    if (g_chart_temp && g_ser_temp) {
-        lv_chart_set_next_value(g_chart_temp, g_ser_temp, (lv_coord_t)temp_c);
+    // Every sample goes to the chart history
+    LIVE_LOCK();
+    g_ch.hist[ch][g_ch.hist_head[ch]] = (int16_t)temp_c;
+    g_ch.ref[ch][g_ch.hist_head[ch]] = g_run.ref_now[ch];
+    g_ch.hist_head[ch] = (uint8_t)((g_ch.hist_head[ch] + 1) % CHART_POINTS);
+    if (ch == g_ch.selected) {
+        if (g_ch.hist_new < CHART_POINTS) g_ch.hist_new++;
+        f |= FIELD_CHART;
     }
+    LIVE_UNLOCK();
+    chamber_mark(ch, f);
 }
 
-void ui_update_pressure(float bar)
+void ui_chamber_update_pressure(int ch, float bar)
 {
-    if (!g_lbl_pressure_value) return;
-    char buf[16];
-    snprintf(buf, sizeof(buf), "%.2f", bar);
-    lv_label_set_text(g_lbl_pressure_value, buf);
+    if (ch < 0 || ch >= g_ch.count) return;
+    int16_t c = (int16_t)(bar * 100.0f + (bar < 0 ? -0.5f : 0.5f));
+    if (c == g_ch.pres_c[ch]) return;
+    g_ch.pres_c[ch] = c;
+    chamber_mark(ch, FIELD_PRESSURE);
 }
 
-void ui_update_ssr_state(bool active)
+void ui_chamber_update_ssr_state(int ch, bool active)
 {
-    // Called from ssr_toggle_cb or from control task
-    (void)active; // GPIO handling done in control task
+    if (ch < 0 || ch >= g_ch.count || g_ch.ssr[ch] == active) return;
+    g_ch.ssr[ch] = active;
+    chamber_mark(ch, FIELD_SSR);
 }
 
-void ui_update_status(const char *status_text)
+void ui_chamber_update_ssr_duty(int ch, float duty)
 {
-    if (g_lbl_status)
-        lv_label_set_text(g_lbl_status, status_text);
+    if (ch < 0 || ch >= g_ch.count) return;
+    int pct = (int)(duty * 100.0f + 0.5f);
+    if (pct < 0)   pct = 0;
+    if (pct > 100) pct = 100;
+    if (pct == g_ch.duty_pct[ch]) return;
+    g_ch.duty_pct[ch] = (uint8_t)pct;
+    chamber_mark(ch, FIELD_SSR);
 }
 
+void ui_chamber_update_status(int ch, const char *status_text)
+{
+    if (ch < 0 || ch >= g_ch.count || !status_text) return;
+    char text[sizeof(g_ch.status[ch])];
+    snprintf(text, sizeof(text), "%s", status_text);
+    LIVE_LOCK();
+    bool same = strcmp(g_ch.status[ch], text) == 0;
+    if (!same) memcpy(g_ch.status[ch], text, sizeof(text));
+    LIVE_UNLOCK();
+    if (same) return;
+    chamber_mark(ch, FIELD_STATUS);
+    chamber_urgent();
+}
+
+void ui_update_temperature(float temp_c)      { ui_chamber_update_temperature(0, temp_c); }
+void ui_update_pressure(float bar)            { ui_chamber_update_pressure(0, bar); }
+void ui_update_ssr_state(bool active)         { ui_chamber_update_ssr_state(0, active); }
+void ui_update_status(const char *status_text) { ui_chamber_update_status(0, status_text); }
+
 void ui_add_log_entry(const char *msg)
 {
     if (!g_log_list) return;
@@ -870,5 +2439,5 @@ void ui_add_log_entry(const char *msg)
     lv_obj_set_style_text_font(btn, &lv_font_montserrat_12, 0);
     lv_obj_set_style_border_width(btn, 0, 0);
     // Auto-scroll to bottom
-    lv_obj_scroll_to_y(g_log_list, LV_COORD_MAX, LV_ANIM_ON);
+    lv_obj_scroll_to_y(g_log_list, LV_COORD_MAX, g_lean ? LV_ANIM_OFF : LV_ANIM_ON);
 }
@@ -1,6 +1,7 @@
 #pragma once
 
 #include "lvgl.h"
+#include "autoclave_ctrl.h"
 
 /* ============================================================
  * Autoclave Control System - LVGL UI
@@ -13,18 +14,123 @@ void ui_home_screen_init(void);
 void ui_monitor_screen_init(void);
 void ui_programs_screen_init(void);
 void ui_settings_screen_init(void);
+void ui_dashboard_screen_init(void);
 void ui_init(void);
 
 // ─── Navigation ──────────────────────────────────────────────
+#define SCREEN_DASHBOARD     4
+#define SCREEN_COUNT         5
+
 void ui_navigate_to(int screen_index);
 
+// ─── Chambers ────────────────────────────────────────────────
+// Call ui_chamber_set_count() before ui_init(); with more than one
+// chamber a dashboard screen is added and home/monitor follow the
+// selected chamber.
+#define MAX_CHAMBERS         8
+
+void ui_chamber_set_count(int n);
+void ui_select_chamber(int chamber);
+int  ui_get_selected_chamber(void);
+
 // ─── Live Data Update API ────────────────────────────────────
+// Updates only store the value and mark the chamber dirty; widgets
+// are redrawn from a UI timer, visiting changed chambers only.
+// Safe to call from any task, e.g. the control task: the dirty
+// marks are atomic, so no change is lost between two flushes.
+// Temperature and pressure are meant to come from an
+// autoclave_sensor channel (publish callback), not raw readings.
+void ui_chamber_update_temperature(int chamber, float temp_c);
+void ui_chamber_update_pressure(int chamber, float bar);
+void ui_chamber_update_ssr_state(int chamber, bool active);
+void ui_chamber_update_ssr_duty(int chamber, float duty);    // Applied, 0..1
+void ui_chamber_update_status(int chamber, const char *status_text);
+
+// Single-chamber shorthands (chamber 0)
 void ui_update_temperature(float temp_c);
 void ui_update_pressure(float bar);
 void ui_update_ssr_state(bool active);
 void ui_update_status(const char *status_text);
 void ui_add_log_entry(const char *msg);
 
+// ─── Persistent settings ─────────────────────────────────────
+typedef struct {
+    float kp, ki, kd;
+    int   setpoint_c;
+    bool  lean_render;          // Low-cost render profile
+    bool  flush_elide;          // Skip unchanged panel transfers
+} ui_settings_t;
+
+const ui_settings_t *ui_get_settings(void);
+void ui_settings_save(void);     // Write pending changes now
+void ui_set_program(int idx, int temp_c, int hold_min, float bar);  // Ignored out of range: 100–140 °C, 1–240 min, 0–4 bar
+
+// ─── SSR command ─────────────────────────────────────────────
+// The SSR button asks the control task to switch a chamber's
+// heater; the button shows whatever ui_chamber_update_ssr_state()
+// reports back, for chamber 0 too. Without a callback only
+// chamber 0 can be switched, directly on this panel's own SSR
+// (autoclave_ssr.h), whose state and duty the UI then polls itself.
+typedef void (*ui_ssr_cmd_cb_t)(int chamber, bool on);
+
+void ui_set_ssr_cmd_cb(ui_ssr_cmd_cb_t cb);
+
+// ─── Cycle runs ──────────────────────────────────────────────
+// Records the chamber's curve into the cycle archive and overlays
+// the program's golden reference curve on the live chart.
+// result: archive_result_t (autoclave_archive.h)
+void ui_cycle_start(int chamber, int program);
+void ui_cycle_end(int chamber, int result);
+
+// ─── Cycle queue ─────────────────────────────────────────────
+// Programs are queued per chamber (autoclave_sched.h) and run back
+// to back; between cycles the chamber is held at standby
+// temperature while the next load goes in. The queue starts and
+// ends the archive recording itself. The control task receives
+// setpoints through the callback (< 0 = heater off) and should
+// pass its identified model on for the timeline estimates. The
+// queue follows the published temperature; without a reading for
+// five seconds it stands still and credits no hold time.
+typedef void (*ui_setpoint_cb_t)(int chamber, float setpoint_c);
+
+void ui_set_setpoint_cb(ui_setpoint_cb_t cb);
+void ui_set_chamber_model(int chamber, const fopdt_model_t *m);
+bool ui_cycle_enqueue(int chamber, int program);
+void ui_cycle_load_ready(int chamber);          // Next load is in, door closed
+// Heater off, queue emptied and the running cycle archived with
+// 'result'. Safe from any task: the call only raises a request,
+// carried out on the LVGL thread at the next queue tick (within
+// a second), so the control task ends failed cycles (sensor fault,
+// over-temperature) here but switches its heater off itself. On
+// the LVGL thread, ui_cycle_end() with a failure result while the
+// queue runs aborts the same way at once, as does the Stop button
+// on the queue card (ARCHIVE_RESULT_ABORTED).
+void ui_cycle_abort(int chamber, int result);
+
+// ─── Render profile ──────────────────────────────────────────
+// Full: shadows, rounded cards, translucent press feedback and
+// animations. Lean: none of those. Switches without rebuilding
+// any screen.
+void ui_set_render_profile(bool lean);
+
+// ─── Flush elision ───────────────────────────────────────────
+// ui_init() sets up autoclave_flush.h for the RGB565 panel and
+// switches it from the settings; the board flush callback passes
+// every area through flush_elide_process().
+void ui_set_flush_elision(bool on);
+
+// ─── Refresh governor ────────────────────────────────────────
+// Refresh and update rates follow touch, animation and urgent
+// changes (autoclave_gov.h). Colour band and status changes are
+// urgent: they wake the backlight and reach the panel within
+// GOV_ALARM_LATENCY_MS plus one render. The update API only flags
+// them; the governor runs on the LVGL thread. Register the input
+// devices before ui_init(): only those are watched for touch.
+typedef void (*ui_backlight_cb_t)(uint8_t pct);
+
+void ui_set_backlight_cb(ui_backlight_cb_t cb);   // Board PWM, 0..100 %
+void ui_set_dim_timeout(uint32_t ms);             // 0 = never dim
+
 // ─── Colour Palette (Material Dark) ─────────────────────────
 #define COLOR_BG_BASE        lv_color_hex(0x121212)   // Screen background
 #define COLOR_BG_SURFACE     lv_color_hex(0x1E1E1E)   // Card / surface
@@ -0,0 +1,269 @@
+/*
+ * ============================================================
+ *  Autoklav — referensvisare för fjärrvisning (Linux)
+ *
+ *  Bygg:   cc -O2 -I.. -o remote_viewer remote_viewer.c \
+ *              ../autoclave_remote.c -lpthread
+ *
+ *  remote_viewer HOST [PORT] [OUT.ppm]
+ *      Ansluter, bygger upp skärmen och skriver en PPM efter
+ *      varje komplett uppdatering.
+ *  remote_viewer --loopback
+ *      Kör sändaren och visaren i samma process över en
+ *      lokal socket och jämför resultatet pixel för pixel.
+ * ============================================================
+ */
+
+#include "autoclave_remote.h"
+#include <arpa/inet.h>
+#include <netdb.h>
+#include <pthread.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/socket.h>
+#include <time.h>
+#include <unistd.h>
+
+typedef struct {
+    int       fd;
+    uint16_t  width, height;
+    uint16_t *fb;
+    uint16_t *area;
+    uint8_t  *payload;
+    size_t    payload_cap;
+    const char *ppm_path;
+    volatile uint32_t frames;
+    volatile uint64_t bytes;
+} viewer_t;
+
+static bool read_exact(int fd, void *buf, size_t n)
+{
+    uint8_t *p = buf;
+    while (n) {
+        ssize_t k = recv(fd, p, n, 0);
+        if (k <= 0) return false;
+        p += k;
+        n -= (size_t)k;
+    }
+    return true;
+}
+
+static uint16_t rd16(const uint8_t *p) { return (uint16_t)(p[0] | p[1] << 8); }
+static uint32_t rd32(const uint8_t *p) { return rd16(p) | (uint32_t)rd16(p + 2) << 16; }
+
+static void write_ppm(const viewer_t *v)
+{
+    char tmp[512];
+    snprintf(tmp, sizeof(tmp), "%s.tmp", v->ppm_path);
+    FILE *f = fopen(tmp, "wb");
+    if (!f) return;
+    fprintf(f, "P6\n%u %u\n255\n", v->width, v->height);
+    for (size_t i = 0; i < (size_t)v->width * v->height; i++) {
+        uint16_t c = v->fb[i];
+        uint8_t rgb[3] = {
+            (uint8_t)((c >> 11) * 255 / 31),
+            (uint8_t)(((c >> 5) & 0x3F) * 255 / 63),
+            (uint8_t)((c & 0x1F) * 255 / 31),
+        };
+        fwrite(rgb, 1, 3, f);
+    }
+    fclose(f);
+    rename(tmp, v->ppm_path);
+}
+
+static bool viewer_open(viewer_t *v, int fd)
+{
+    uint8_t hello[12];
+    if (!read_exact(fd, hello, sizeof(hello))) return false;
+    if (rd32(hello) != REMOTE_MAGIC || hello[8] != REMOTE_VERSION ||
+        hello[9] != REMOTE_FORMAT_RGB565) {
+        fprintf(stderr, "remote_viewer: not an autoklav stream\n");
+        return false;
+    }
+    v->fd = fd;
+    v->width = rd16(hello + 4);
+    v->height = rd16(hello + 6);
+    size_t px = (size_t)v->width * v->height;
+    v->fb = calloc(px, sizeof(uint16_t));
+    v->area = malloc(px * sizeof(uint16_t));
+    v->payload_cap = px * 2 + px / 64 + 16;
+    v->payload = malloc(v->payload_cap);
+    return v->fb && v->area && v->payload;
+}
+
+// Applies areas until the connection closes
+static void viewer_run(viewer_t *v)
+{
+    uint8_t h[16];
+    while (read_exact(v->fd, h, sizeof(h))) {
+        uint16_t x1 = rd16(h), y1 = rd16(h + 2), x2 = rd16(h + 4), y2 = rd16(h + 6);
+        uint8_t codec = h[8], flags = h[9];
+        uint32_t len = rd32(h + 12);
+        if (x2 >= v->width || y2 >= v->height || x2 < x1 || y2 < y1 || len > v->payload_cap) {
+            fprintf(stderr, "remote_viewer: bad area header\n");
+            return;
+        }
+        if (!read_exact(v->fd, v->payload, len)) return;
+        v->bytes += sizeof(h) + len;
+
+        size_t w = (size_t)(x2 - x1 + 1), n = w * (size_t)(y2 - y1 + 1);
+        if (codec == REMOTE_CODEC_RLE) {
+            if (remote_rle_decode(v->payload, len, v->area, n) != n) {
+                fprintf(stderr, "remote_viewer: corrupt area\n");
+                return;
+            }
+        } else if (codec == REMOTE_CODEC_RAW && len == n * 2) {
+            for (size_t i = 0; i < n; i++) v->area[i] = rd16(v->payload + 2 * i);
+        } else {
+            fprintf(stderr, "remote_viewer: unknown codec %u\n", codec);
+            return;
+        }
+
+        for (size_t y = y1; y <= y2; y++)
+            memcpy(v->fb + y * v->width + x1, v->area + (y - y1) * w, w * 2);
+
+        if (flags & REMOTE_FLAG_LAST) {
+            v->frames++;
+            if (v->ppm_path) write_ppm(v);
+        }
+    }
+}
+
+static int connect_to(const char *host, const char *port)
+{
+    struct addrinfo hints = { .ai_family = AF_INET, .ai_socktype = SOCK_STREAM }, *res;
+    if (getaddrinfo(host, port, &hints, &res) != 0) return -1;
+    int fd = socket(res->ai_family, res->ai_socktype, 0);
+    if (fd >= 0 && connect(fd, res->ai_addr, res->ai_addrlen) < 0) {
+        close(fd);
+        fd = -1;
+    }
+    freeaddrinfo(res);
+    return fd;
+}
+
+// ═══════════════════════════════════════════════════════════════
+//  LOOPBACK
+// ═══════════════════════════════════════════════════════════════
+#define LB_W        720
+#define LB_H        720
+#define LB_BAND     72          // Rows per partial draw buffer
+
+static void *viewer_thread(void *arg)
+{
+    viewer_t *v = arg;
+    char port[8];
+    snprintf(port, sizeof(port), "%u", remote_view_port());
+    int fd = connect_to("127.0.0.1", port);
+    if (fd >= 0 && viewer_open(v, fd)) viewer_run(v);
+    if (fd >= 0) close(fd);
+    return NULL;
+}
+
+static void pump(int rounds)
+{
+    struct timespec ts = { 0, 200000 };
+    while (rounds--) {
+        remote_view_poll();
+        nanosleep(&ts, NULL);
+    }
+}
+
+static bool wait_frames(viewer_t *v, uint32_t n)
+{
+    for (int i = 0; i < 10000 && v->frames < n; i++) pump(1);
+    return v->frames >= n;
+}
+
+// Draws the synthetic screen: flat background, cards, a gradient
+static void paint(uint16_t *fb, int value)
+{
+    for (int y = 0; y < LB_H; y++)
+        for (int x = 0; x < LB_W; x++) {
+            uint16_t c = 0x10A2;
+            if (x >= 16 && x < 704 && y >= 80 && y < 400) c = 0x2124;
+            if (y >= 600 && y < 640) c = (uint16_t)(x * 32 / LB_W) << 11;
+            if (x >= 300 && x < 400 && y >= 200 && y < 240 && ((x + y + value) % 7 == 0))
+                c = 0xFFFF;
+            fb[y * LB_W + x] = c;
+        }
+}
+
+static int loopback(void)
+{
+    if (!remote_view_start(0, LB_W, LB_H)) {
+        fprintf(stderr, "loopback: listen failed\n");
+        return 1;
+    }
+    viewer_t v = { 0 };
+    pthread_t th;
+    pthread_create(&th, NULL, viewer_thread, &v);
+
+    // Connection triggers a resync; the UI would invalidate the screen
+    int i;
+    for (i = 0; i < 10000 && !remote_view_take_resync(); i++) pump(1);
+    if (i == 10000) {
+        fprintf(stderr, "loopback: viewer never connected\n");
+        return 1;
+    }
+
+    uint16_t *ref = malloc(LB_W * LB_H * sizeof(uint16_t));
+    paint(ref, 0);
+    for (int y = 0; y < LB_H; y += LB_BAND) {
+        remote_view_on_flush(0, y, LB_W - 1, y + LB_BAND - 1, ref + y * LB_W,
+                             y + LB_BAND >= LB_H);
+        pump(20);
+    }
+    bool ok = wait_frames(&v, 1);
+    uint64_t full = v.bytes;
+
+    // A changed value label: only its area is flushed
+    static uint16_t label[100 * 40];
+    paint(ref, 3);
+    for (int y = 0; y < 40; y++)
+        memcpy(label + y * 100, ref + (200 + y) * LB_W + 300, 100 * 2);
+    remote_view_on_flush(300, 200, 399, 239, label, true);
+    ok = ok && wait_frames(&v, 2);
+    uint64_t delta = v.bytes - full;
+
+    remote_stats_t st;
+    remote_view_get_stats(&st);
+    remote_view_stop();
+    pthread_join(th, NULL);
+
+    ok = ok && st.dropped == 0 && memcmp(v.fb, ref, LB_W * LB_H * 2) == 0;
+    printf("full frame: %llu bytes (raw %u), label update: %llu bytes (raw %u)\n",
+           (unsigned long long)full, LB_W * LB_H * 2,
+           (unsigned long long)delta, 100 * 40 * 2);
+    printf("loopback: %s\n", ok ? "OK" : "FAILED");
+    return ok ? 0 : 1;
+}
+
+// ═══════════════════════════════════════════════════════════════
+//  MAIN
+// ═══════════════════════════════════════════════════════════════
+int main(int argc, char **argv)
+{
+    if (argc >= 2 && strcmp(argv[1], "--loopback") == 0) return loopback();
+    if (argc < 2) {
+        fprintf(stderr, "usage: %s HOST [PORT] [OUT.ppm] | --loopback\n", argv[0]);
+        return 2;
+    }
+
+    char port[8];
+    snprintf(port, sizeof(port), "%u", argc > 2 ? (unsigned)atoi(argv[2]) : REMOTE_DEFAULT_PORT);
+    int fd = connect_to(argv[1], port);
+    if (fd < 0) {
+        perror("connect");
+        return 1;
+    }
+
+    viewer_t v = { .ppm_path = argc > 3 ? argv[3] : "autoklav.ppm" };
+    if (!viewer_open(&v, fd)) return 1;
+    printf("%ux%u, writing %s\n", v.width, v.height, v.ppm_path);
+    viewer_run(&v);
+    printf("%u frames, %llu bytes\n", v.frames, (unsigned long long)v.bytes);
+    close(fd);
+    return 0;
+}